@@ -0,0 +1,10 @@
+define([
+    "binmod/helper/helper"
+], function(helper) {
+    "use strict";
+    return {
+        main: function() {
+            return helper.value(42);
+        }
+    };
+});
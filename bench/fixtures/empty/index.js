@@ -0,0 +1,7 @@
+define([], function() {
+    "use strict";
+    return {
+        main: function() {
+        }
+    };
+});
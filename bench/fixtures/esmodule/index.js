@@ -0,0 +1,3 @@
+import { value } from "./value.js";
+
+value(42);
@@ -0,0 +1,3 @@
+export function value(x) {
+    return x + 1;
+}
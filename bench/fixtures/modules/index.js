@@ -0,0 +1,46 @@
+define([
+    "modules/lib/mod01",
+    "modules/lib/mod02",
+    "modules/lib/mod03",
+    "modules/lib/mod04",
+    "modules/lib/mod05",
+    "modules/lib/mod06",
+    "modules/lib/mod07",
+    "modules/lib/mod08",
+    "modules/lib/mod09",
+    "modules/lib/mod10",
+    "modules/lib/mod11",
+    "modules/lib/mod12",
+    "modules/lib/mod13",
+    "modules/lib/mod14",
+    "modules/lib/mod15",
+    "modules/lib/mod16",
+    "modules/lib/mod17",
+    "modules/lib/mod18",
+    "modules/lib/mod19",
+    "modules/lib/mod20",
+    "modules/lib/mod21",
+    "modules/lib/mod22",
+    "modules/lib/mod23",
+    "modules/lib/mod24",
+    "modules/lib/mod25",
+    "modules/lib/mod26",
+    "modules/lib/mod27",
+    "modules/lib/mod28",
+    "modules/lib/mod29",
+    "modules/lib/mod30",
+    "modules/lib/mod31",
+    "modules/lib/mod32"
+], function() {
+    "use strict";
+    var mods = Array.prototype.slice.call(arguments);
+    return {
+        main: function() {
+            var sum = 0;
+            for (var i = 0; i < mods.length; i++) {
+                sum = mods[i].value(sum);
+            }
+            return sum;
+        }
+    };
+});
@@ -0,0 +1,9 @@
+define([], function() {
+    "use strict";
+    return {
+        name: "mod01",
+        value: function(x) {
+            return x + 1;
+        }
+    };
+});
@@ -0,0 +1,9 @@
+define([], function() {
+    "use strict";
+    return {
+        name: "mod14",
+        value: function(x) {
+            return x + 14;
+        }
+    };
+});
@@ -0,0 +1,362 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   wilton_cli_bench.cpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:30 AM
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "staticlib/config.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+namespace { // anonymous
+
+const std::string usage_msg = "USAGE: wilton_cli_bench [-n runs] [-o results.json] [--drop-caches]"
+        " path/to/wilton path/to/bench/fixtures";
+
+struct bench_options {
+    std::string wilton_exec;
+    std::string fixtures_dir;
+    std::string output;
+    size_t runs = 20;
+    bool drop_caches = false;
+};
+
+struct fixture {
+    std::string name;
+    std::vector<std::string> args;
+    // empty - run with all available engines
+    std::vector<std::string> engines;
+};
+
+struct sample {
+    bool success = false;
+    double wall_ms = 0;
+    int64_t max_rss_kb = 0;
+    int64_t minor_faults = 0;
+    int64_t major_faults = 0;
+};
+
+bench_options parse_options(int argc, char** argv) {
+    auto res = bench_options();
+    auto positional = std::vector<std::string>();
+    for (int i = 1; i < argc; i++) {
+        auto ar = std::string(argv[i]);
+        if ("-n" == ar && i + 1 < argc) {
+            res.runs = sl::utils::parse_uint32(argv[++i]);
+        } else if ("-o" == ar && i + 1 < argc) {
+            res.output = std::string(argv[++i]);
+        } else if ("--drop-caches" == ar) {
+            res.drop_caches = true;
+        } else {
+            positional.emplace_back(ar);
+        }
+    }
+    if (2 != positional.size() || 0 == res.runs) {
+        throw std::runtime_error(usage_msg);
+    }
+    res.wilton_exec = sl::tinydir::full_path(positional.at(0));
+    res.fixtures_dir = sl::tinydir::full_path(positional.at(1));
+    while (sl::utils::ends_with(res.fixtures_dir, "/")) {
+        res.fixtures_dir.pop_back();
+    }
+    return res;
+}
+
+std::vector<fixture> list_fixtures(const std::string& dir) {
+    auto res = std::vector<fixture>();
+    res.push_back({"empty", {dir + "/empty/index.js"}, {}});
+    res.push_back({"modules", {dir + "/modules/index.js"}, {}});
+    res.push_back({"esmodule", {dir + "/esmodule/index.js"}, {"quickjs"}});
+    res.push_back({"one-liner", {"-e", "", "1 + 1"}, {}});
+    res.push_back({"binary-modules", {dir + "/binmod/index.js",
+            "-b", dir + "/binmod/helper.wlib"}, {}});
+    // GHC app is built outside of this repo, 'libname:callname'
+    auto ghc = std::getenv("WILTON_BENCH_GHC_STARTUP");
+    if (nullptr != ghc && '\0' != ghc[0]) {
+        res.push_back({"ghc", {"-g", std::string(ghc)}, {"ghc"}});
+    }
+    return res;
+}
+
+std::vector<std::string> available_engines(const std::string& wilton_exec) {
+    auto bindir = sl::utils::strip_filename(wilton_exec);
+#ifdef STATICLIB_MAC
+    auto ext = std::string(".dylib");
+#else // !STATICLIB_MAC
+    auto ext = std::string(".so");
+#endif // STATICLIB_MAC
+    auto res = std::vector<std::string>();
+    for (auto name : {"quickjs", "duktape"}) {
+        auto lib = sl::tinydir::path(bindir + "libwilton_" + name + ext);
+        if (lib.exists()) {
+            res.emplace_back(name);
+        }
+    }
+    auto java_home = std::getenv("JAVA_HOME");
+    auto jar = sl::tinydir::path(bindir + "wilton_rhino.jar");
+    if (nullptr != java_home && '\0' != java_home[0] && jar.exists()) {
+        res.emplace_back("rhino");
+        res.emplace_back("nashorn");
+    }
+    return res;
+}
+
+bool drop_page_cache() {
+    ::sync();
+    auto fd = ::open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if (-1 == fd) {
+        return false;
+    }
+    auto written = ::write(fd, "3", 1);
+    ::close(fd);
+    return 1 == written;
+}
+
+sample run_once(const std::string& wilton_exec, const std::vector<std::string>& args) {
+    auto argv = std::vector<char*>();
+    argv.push_back(const_cast<char*>(wilton_exec.c_str()));
+    for (auto& ar : args) {
+        argv.push_back(const_cast<char*>(ar.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = ::fork();
+    if (-1 == pid) {
+        throw std::runtime_error("fork error: [" + std::string(::strerror(errno)) + "]");
+    }
+    if (0 == pid) {
+        auto devnull = ::open("/dev/null", O_RDWR);
+        if (-1 != devnull) {
+            ::dup2(devnull, STDIN_FILENO);
+            ::dup2(devnull, STDOUT_FILENO);
+            ::close(devnull);
+        }
+        ::execv(wilton_exec.c_str(), argv.data());
+        ::_exit(127);
+    }
+    int status = 0;
+    struct rusage ru;
+    std::memset(std::addressof(ru), '\0', sizeof(ru));
+    while (-1 == ::wait4(pid, std::addressof(status), 0, std::addressof(ru)) && EINTR == errno);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    auto res = sample();
+    res.success = WIFEXITED(status) && 0 == WEXITSTATUS(status);
+    res.wall_ms = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) / 1000;
+#ifdef STATICLIB_MAC
+    res.max_rss_kb = static_cast<int64_t>(ru.ru_maxrss / 1024);
+#else // !STATICLIB_MAC
+    res.max_rss_kb = static_cast<int64_t>(ru.ru_maxrss);
+#endif // STATICLIB_MAC
+    res.minor_faults = static_cast<int64_t>(ru.ru_minflt);
+    res.major_faults = static_cast<int64_t>(ru.ru_majflt);
+    return res;
+}
+
+// nearest-rank percentile over sorted values
+template<typename T>
+T percentile(const std::vector<T>& sorted, double pc) {
+    if (sorted.empty()) {
+        return T();
+    }
+    auto rank = static_cast<size_t>(pc / 100 * static_cast<double>(sorted.size()) + 0.999999);
+    auto idx = std::min(sorted.size(), std::max(rank, static_cast<size_t>(1))) - 1;
+    return sorted.at(idx);
+}
+
+template<typename T>
+sl::json::value stats(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+    return {
+        {"min", percentile(values, 0)},
+        {"median", percentile(values, 50)},
+        {"p95", percentile(values, 95)},
+        {"p99", percentile(values, 99)},
+        {"max", percentile(values, 100)}
+    };
+}
+
+sl::json::value summarize(const fixture& fx, const std::string& engine, const std::string& mode,
+        const std::vector<sample>& samples) {
+    auto wall = std::vector<double>();
+    auto rss = std::vector<int64_t>();
+    auto minflt = std::vector<int64_t>();
+    auto majflt = std::vector<int64_t>();
+    int64_t failed = 0;
+    for (auto& sa : samples) {
+        if (!sa.success) {
+            failed += 1;
+            continue;
+        }
+        wall.push_back(sa.wall_ms);
+        rss.push_back(sa.max_rss_kb);
+        minflt.push_back(sa.minor_faults);
+        majflt.push_back(sa.major_faults);
+    }
+    return {
+        {"fixture", fx.name},
+        {"engine", engine},
+        {"mode", mode},
+        {"runs", static_cast<int64_t>(samples.size())},
+        {"failed", failed},
+        {"wallMs", stats(std::move(wall))},
+        {"maxRssKb", stats(std::move(rss))},
+        {"minorFaults", stats(std::move(minflt))},
+        {"majorFaults", stats(std::move(majflt))}
+    };
+}
+
+std::vector<std::string> engine_args(const fixture& fx, const std::string& engine,
+        const std::string& cache_dir) {
+    auto res = std::vector<std::string>();
+    if ("ghc" != engine) {
+        res.emplace_back("-j");
+        res.emplace_back(engine);
+        res.emplace_back("--startup-cache");
+        res.emplace_back(cache_dir + "/startup");
+    }
+    for (auto& ar : fx.args) {
+        res.emplace_back(ar);
+    }
+    return res;
+}
+
+void remove_dir(const std::string& dir) {
+    auto path = sl::tinydir::path(dir);
+    if (!path.exists()) {
+        return;
+    }
+    for (auto& ch : sl::tinydir::list_directory(dir)) {
+        if (ch.is_directory()) {
+            remove_dir(ch.filepath());
+        } else {
+            ch.remove();
+        }
+    }
+    path.remove();
+}
+
+// Cold runs start with empty startup cache (and with dropped OS page
+// cache when permitted), warm runs share the cache primed by one
+// unmeasured launch.
+sl::json::value run_fixture(const bench_options& opts, const fixture& fx,
+        const std::string& engine, const std::string& work_dir, bool& caches_dropped) {
+    auto cache_dir = work_dir + "/" + fx.name + "_" + engine;
+    auto args = engine_args(fx, engine, cache_dir);
+    auto results = std::vector<sl::json::value>();
+
+    auto cold = std::vector<sample>();
+    for (size_t i = 0; i < opts.runs; i++) {
+        remove_dir(cache_dir);
+        sl::tinydir::create_directory(cache_dir);
+        if (opts.drop_caches) {
+            caches_dropped = drop_page_cache() && caches_dropped;
+        }
+        cold.push_back(run_once(opts.wilton_exec, args));
+    }
+    results.emplace_back(summarize(fx, engine, "cold", cold));
+
+    auto warm = std::vector<sample>();
+    remove_dir(cache_dir);
+    sl::tinydir::create_directory(cache_dir);
+    run_once(opts.wilton_exec, args);
+    for (size_t i = 0; i < opts.runs; i++) {
+        warm.push_back(run_once(opts.wilton_exec, args));
+    }
+    results.emplace_back(summarize(fx, engine, "warm", warm));
+    remove_dir(cache_dir);
+    return sl::json::value(std::move(results));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        auto opts = parse_options(argc, argv);
+        auto engines = available_engines(opts.wilton_exec);
+        if (engines.empty()) {
+            std::cerr << "ERROR: no JS engines found next to: [" << opts.wilton_exec << "]" << std::endl;
+            return 1;
+        }
+        auto rsg = sl::utils::random_string_generator();
+        auto work_dir = std::string("/tmp/wilton_bench_") + rsg.generate(8);
+        sl::tinydir::create_directory(work_dir);
+        auto work_cleaner = sl::support::defer([&work_dir]() STATICLIB_NOEXCEPT {
+            try {
+                remove_dir(work_dir);
+            } catch (const std::exception&) {
+                // ignore
+            }
+        });
+
+        auto results = std::vector<sl::json::value>();
+        bool caches_dropped = opts.drop_caches;
+        for (auto& fx : list_fixtures(opts.fixtures_dir)) {
+            auto& fx_engines = fx.engines.empty() ? engines : fx.engines;
+            for (auto& en : fx_engines) {
+                if ("ghc" != en && engines.end() == std::find(engines.begin(), engines.end(), en)) {
+                    continue;
+                }
+                std::cerr << "Running fixture: [" << fx.name << "], engine: [" << en << "]" << std::endl;
+                auto pair = run_fixture(opts, fx, en, work_dir, caches_dropped);
+                for (auto& va : pair.as_array_or_throw()) {
+                    results.emplace_back(va.clone());
+                }
+            }
+        }
+
+        auto json = sl::json::dumps({
+            {"wiltonExecutable", opts.wilton_exec},
+            {"runs", static_cast<int64_t>(opts.runs)},
+            {"pageCacheDropped", caches_dropped},
+            {"results", std::move(results)}
+        });
+        if (opts.output.empty()) {
+            std::cout << json << std::endl;
+        } else {
+            std::ofstream out(opts.output);
+            out << json << std::endl;
+            std::cerr << "Results written: [" << opts.output << "]" << std::endl;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   allocator.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:40 AM
+ */
+
+#ifndef WILTON_CLI_ALLOCATOR_HPP
+#define WILTON_CLI_ALLOCATOR_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_LINUX
+#include <malloc.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace cli {
+namespace allocator {
+
+// set for the re-executed launcher to not re-exec it again, value is
+// a list of variables changed for re-exec, their original values are
+// passed with prefixed names
+const std::string reexec_marker_env_var = "WILTON_ALLOCATOR_REEXEC";
+const std::string reexec_orig_prefix = "WILTON_ALLOCATOR_ORIG_";
+
+struct settings {
+    // glibc 'M_ARENA_MAX', 'M_TRIM_THRESHOLD' and 'M_MMAP_THRESHOLD', '-1' keeps the default
+    int arenas = -1;
+    int64_t trim_threshold = -1;
+    int64_t mmap_threshold = -1;
+    // 'always' or 'never', empty keeps system default
+    std::string thp;
+    // allocator library file name from 'wilton_home/bin', for example 'libjemalloc.so.2'
+    std::string preload;
+    bool report_rss = false;
+
+    bool empty() const {
+        return arenas < 0 && trim_threshold < 0 && mmap_threshold < 0 &&
+                thp.empty() && preload.empty() && !report_rss;
+    }
+};
+
+namespace { // anonymous
+
+// passed to 'mallopt' as 'int'
+int64_t read_threshold(const sl::json::value& val, const std::string& ctx) {
+    auto res = val.as_int32_or_throw(ctx);
+    if (res < 0) throw support::exception(TRACEMSG(
+            "Invalid negative value: [" + sl::support::to_string(res) + "], " + ctx));
+    return static_cast<int64_t>(res);
+}
+
+} // namespace
+
+// values from 'allocator' section of 'conf/config.json',
+// command line ones take precedence
+settings merge(const settings& cli, const sl::json::value& conf) {
+    auto res = cli;
+    auto ctx = std::string("conf/config.json:allocator");
+    static const std::vector<sl::json::field> no_fields;
+    const auto& fields = sl::json::type::object == conf.json_type() ? conf.as_object() : no_fields;
+    for (auto& fi : fields) {
+        if ("mallocArenas" == fi.name()) {
+            if (res.arenas < 0) {
+                res.arenas = static_cast<int>(fi.val().as_uint16_or_throw(ctx + ".mallocArenas"));
+            }
+        } else if ("trimThreshold" == fi.name()) {
+            if (res.trim_threshold < 0) {
+                res.trim_threshold = read_threshold(fi.val(), ctx + ".trimThreshold");
+            }
+        } else if ("mmapThreshold" == fi.name()) {
+            if (res.mmap_threshold < 0) {
+                res.mmap_threshold = read_threshold(fi.val(), ctx + ".mmapThreshold");
+            }
+        } else if ("transparentHugePages" == fi.name()) {
+            if (res.thp.empty()) {
+                res.thp = fi.val().as_string_nonempty_or_throw(ctx + ".transparentHugePages");
+            }
+        } else if ("preload" == fi.name()) {
+            if (res.preload.empty()) {
+                res.preload = fi.val().as_string_nonempty_or_throw(ctx + ".preload");
+            }
+        } else if ("reportRss" == fi.name()) {
+            res.report_rss = res.report_rss || fi.val().as_bool_or_throw(ctx + ".reportRss");
+        } else throw support::exception(TRACEMSG("Unknown field: [" + fi.name() + "], " + ctx));
+    }
+    if (!res.thp.empty() && "always" != res.thp && "never" != res.thp) throw support::exception(TRACEMSG(
+            "Invalid transparent huge pages value: [" + res.thp + "], supported: 'always', 'never'"));
+    if (std::string::npos != res.preload.find('/')) throw support::exception(TRACEMSG(
+            "Allocator library must be specified as a file name in 'WILTON_HOME/bin', value: [" + res.preload + "]"));
+    return res;
+}
+
+#ifdef STATICLIB_LINUX
+
+namespace { // anonymous
+
+bool& reexecuted_flag() {
+    static bool flag = false;
+    return flag;
+}
+
+// original value is kept to be restored in the re-executed launcher
+void prepend_env(const std::string& name, const std::string& value, char sep, std::string& changed) {
+    auto prev = std::getenv(name.c_str());
+    auto val = value;
+    if (nullptr != prev) {
+        auto prev_str = std::string(prev);
+        ::setenv((reexec_orig_prefix + name).c_str(), prev_str.c_str(), 1);
+        if (!prev_str.empty()) {
+            val = value + sep + prev_str;
+        }
+    }
+    ::setenv(name.c_str(), val.c_str(), 1);
+    changed.append(changed.empty() ? "" : ":").append(name);
+}
+
+} // namespace
+
+// Must be called at the start of 'main', before the environment is read.
+// Dynamic loader has already consumed the variables set for re-exec, they
+// are reverted, so they are not inherited by child processes and a nested
+// launcher with allocator options does its own re-exec.
+void restore_env_after_reexec() {
+    auto marker = std::getenv(reexec_marker_env_var.c_str());
+    if (nullptr == marker) {
+        return;
+    }
+    reexecuted_flag() = true;
+    auto changed = std::string(marker);
+    ::unsetenv(reexec_marker_env_var.c_str());
+    for (auto& name : sl::utils::split(changed, ':')) {
+        auto orig_name = reexec_orig_prefix + name;
+        auto orig = std::getenv(orig_name.c_str());
+        if (nullptr != orig) {
+            auto orig_str = std::string(orig);
+            ::setenv(name.c_str(), orig_str.c_str(), 1);
+            ::unsetenv(orig_name.c_str());
+        } else {
+            ::unsetenv(name.c_str());
+        }
+    }
+}
+
+// Preloaded allocator and malloc tunables are only picked up by the dynamic
+// loader at process start, launcher is restarted with the updated environment
+// when they are requested. Must be called before any threads are started.
+// Returns normally if re-exec is not needed.
+void reexec_if_needed(const settings& st, const std::string& wilton_home, char** argv) {
+    auto needs_preload = !st.preload.empty();
+    auto needs_tunables = "always" == st.thp;
+    if (!(needs_preload || needs_tunables) || reexecuted_flag()) {
+        return;
+    }
+    auto changed = std::string();
+    if (needs_preload) {
+        auto lib = wilton_home + "bin/" + st.preload;
+        if (!sl::tinydir::path(lib).exists()) throw support::exception(TRACEMSG(
+                "Allocator library not found, path: [" + lib + "]"));
+        prepend_env("LD_PRELOAD", lib, ':', changed);
+    }
+    if (needs_tunables) {
+        // malloc advises huge pages for its heaps, glibc 2.35+
+        prepend_env("GLIBC_TUNABLES", "glibc.malloc.hugetlb=1", ':', changed);
+    }
+    ::setenv(reexec_marker_env_var.c_str(), changed.c_str(), 1);
+    std::cout.flush();
+    std::cerr.flush();
+    ::execv("/proc/self/exe", argv);
+    auto msg = std::string(::strerror(errno));
+    restore_env_after_reexec();
+    reexecuted_flag() = false;
+    throw support::exception(TRACEMSG("Launcher re-exec error: [" + msg + "]"));
+}
+
+// mallopt is applied to glibc malloc, with preloaded allocator these
+// calls are no-op and the allocator is tuned with its own env vars
+void apply(const settings& st) {
+    if (st.arenas >= 0 && 1 != ::mallopt(M_ARENA_MAX, st.arenas)) throw support::exception(TRACEMSG(
+            "'mallopt' error, option: [M_ARENA_MAX], value: [" + sl::support::to_string(st.arenas) + "]"));
+    if (st.trim_threshold >= 0 && 1 != ::mallopt(M_TRIM_THRESHOLD, static_cast<int>(st.trim_threshold))) {
+        throw support::exception(TRACEMSG("'mallopt' error, option: [M_TRIM_THRESHOLD]," +
+                " value: [" + sl::support::to_string(st.trim_threshold) + "]"));
+    }
+    if (st.mmap_threshold >= 0 && 1 != ::mallopt(M_MMAP_THRESHOLD, static_cast<int>(st.mmap_threshold))) {
+        throw support::exception(TRACEMSG("'mallopt' error, option: [M_MMAP_THRESHOLD]," +
+                " value: [" + sl::support::to_string(st.mmap_threshold) + "]"));
+    }
+    if ("never" == st.thp && 0 != ::prctl(PR_SET_THP_DISABLE, 1, 0, 0, 0)) throw support::exception(TRACEMSG(
+            "'prctl(PR_SET_THP_DISABLE)' error: [" + std::string(::strerror(errno)) + "]"));
+}
+
+// 'VmRSS' and 'VmHWM' from '/proc/self/status', in kB
+void print_rss_report() {
+    try {
+        auto src = sl::tinydir::file_source("/proc/self/status");
+        auto buf = sl::io::make_buffered_source(src);
+        auto current = std::string("-1");
+        auto peak = std::string("-1");
+        for (;;) {
+            auto line = buf.read_line();
+            if (line.empty()) {
+                break;
+            }
+            if (sl::utils::starts_with(line, "VmRSS:")) {
+                current = sl::utils::trim(line.substr(6));
+            } else if (sl::utils::starts_with(line, "VmHWM:")) {
+                peak = sl::utils::trim(line.substr(6));
+            }
+        }
+        std::cerr << "Memory usage, RSS current: [" << current << "], peak: [" << peak << "]" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "WARNING: cannot read memory usage, error: [" << e.what() << "]" << std::endl;
+    }
+}
+
+#else // !STATICLIB_LINUX
+
+void restore_env_after_reexec() {
+    // no-op
+}
+
+void reexec_if_needed(const settings& st, const std::string&, char**) {
+    if (!st.preload.empty() || !st.thp.empty()) throw support::exception(TRACEMSG(
+            "Allocator preload and transparent huge pages options are supported on Linux only"));
+}
+
+void apply(const settings& st) {
+    if (st.arenas >= 0 || st.trim_threshold >= 0 || st.mmap_threshold >= 0) throw support::exception(TRACEMSG(
+            "Malloc tuning options are supported on Linux only"));
+}
+
+void print_rss_report() {
+    std::cerr << "WARNING: memory usage report is supported on Linux only" << std::endl;
+}
+
+#endif // STATICLIB_LINUX
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_ALLOCATOR_HPP */
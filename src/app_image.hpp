@@ -0,0 +1,480 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   app_image.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:34 AM
+ */
+
+#ifndef WILTON_CLI_APP_IMAGE_HPP
+#define WILTON_CLI_APP_IMAGE_HPP
+
+#include <cctype>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/unzip.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+#include "wilton/support/misc.hpp"
+
+#include "startup_trace.hpp"
+#include "zip_index.hpp"
+#include "zip_writer.hpp"
+
+namespace wilton {
+namespace cli {
+namespace image {
+
+const std::string manifest_entry_name = "wilton-image.json";
+const std::string image_postfix = ".wimg";
+const int64_t image_format_version = 1;
+
+// always needed by engines to bootstrap requirejs
+const std::string requirejs_package = "wilton-requirejs";
+
+bool is_image(const std::string& path) {
+    return sl::utils::ends_with(path, image_postfix);
+}
+
+// Part of the modules tree copied into image as a whole: a requireJs 'paths'
+// entry (app dir, vendor lib or binary module) or a top-level std package.
+struct unit {
+    std::string name;
+    // 'dir', 'zip' or 'file'
+    std::string kind;
+    std::string path;
+    // dir or zip entries prefix, ends with '/' if not empty
+    std::string prefix;
+};
+
+struct build_params {
+    std::string output;
+    std::string wilton_version;
+    std::string startmod;
+    std::string startmod_id;
+    std::string std_modurl;
+    std::vector<sl::json::field> paths;
+    std::vector<sl::json::value> packages;
+    sl::support::optional<sl::json::value> app_config;
+    std::vector<std::string> includes;
+};
+
+struct manifest {
+    std::string startmod;
+    std::string startmod_id;
+    std::vector<sl::json::field> paths;
+    std::vector<sl::json::value> packages;
+    sl::support::optional<sl::json::value> app_config;
+};
+
+namespace { // anonymous
+
+bool is_ident_char(char ch) {
+    return std::isalnum(static_cast<unsigned char>(ch)) || '_' == ch || '$' == ch || '.' == ch;
+}
+
+void skip_space(const std::string& src, size_t& pos) {
+    while (pos < src.length() && std::isspace(static_cast<unsigned char>(src[pos]))) {
+        pos += 1;
+    }
+}
+
+bool read_string_literal(const std::string& src, size_t& pos, std::string& out) {
+    if (pos >= src.length() || ('"' != src[pos] && '\'' != src[pos])) {
+        return false;
+    }
+    auto quote = src[pos];
+    auto end = src.find(quote, pos + 1);
+    if (std::string::npos == end) {
+        return false;
+    }
+    out = src.substr(pos + 1, end - pos - 1);
+    pos = end + 1;
+    return true;
+}
+
+void read_string_array(const std::string& src, size_t& pos, std::vector<std::string>& out) {
+    if (pos >= src.length() || '[' != src[pos]) {
+        return;
+    }
+    pos += 1;
+    for (;;) {
+        skip_space(src, pos);
+        auto id = std::string();
+        if (!read_string_literal(src, pos, id)) {
+            return;
+        }
+        out.emplace_back(std::move(id));
+        skip_space(src, pos);
+        if (pos >= src.length() || ',' != src[pos]) {
+            return;
+        }
+        pos += 1;
+    }
+}
+
+std::string url_path(const std::string& url, const std::string& prefix) {
+    return url.substr(prefix.length());
+}
+
+std::vector<std::string> list_dir_recursive(const std::string& dir, const std::string& rel) {
+    auto res = std::vector<std::string>();
+    auto path = sl::tinydir::path(dir + rel);
+    if (!path.exists()) {
+        return res;
+    }
+    for (auto& ch : sl::tinydir::list_directory(dir + rel)) {
+        auto ch_rel = rel + ch.filename();
+        if (ch.is_directory()) {
+            auto nested = list_dir_recursive(dir, ch_rel + "/");
+            std::move(nested.begin(), nested.end(), std::back_inserter(res));
+        } else {
+            res.emplace_back(std::move(ch_rel));
+        }
+    }
+    return res;
+}
+
+std::string read_file(const std::string& path) {
+    auto src = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return std::move(sink.get_string());
+}
+
+std::string read_zip_entry(const std::string& zip_path, const std::string& entry) {
+    auto idx = zip::open_index(zip_path);
+    auto stream = sl::unzip::open_zip_entry(*idx, entry);
+    return std::string(std::istreambuf_iterator<char>(stream->rdbuf()),
+            std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+// Collects module IDs from 'define([...])', 'require([...])' and 'require("...")'
+// calls. IDs built at runtime cannot be found this way, such modules can be
+// listed in 'imageInclude' in 'conf/config.json'.
+std::vector<std::string> scan_dependencies(const std::string& src) {
+    auto res = std::vector<std::string>();
+    for (auto fun : {"define", "require"}) {
+        auto fun_str = std::string(fun);
+        size_t pos = 0;
+        while (std::string::npos != (pos = src.find(fun_str, pos))) {
+            auto start = pos;
+            pos += fun_str.length();
+            if (start > 0 && is_ident_char(src[start - 1])) {
+                continue;
+            }
+            skip_space(src, pos);
+            if (pos >= src.length() || '(' != src[pos]) {
+                continue;
+            }
+            pos += 1;
+            skip_space(src, pos);
+            auto id = std::string();
+            if (read_string_literal(src, pos, id)) {
+                if ("require" == fun_str) {
+                    res.emplace_back(std::move(id));
+                    continue;
+                }
+                // named define
+                skip_space(src, pos);
+                if (pos < src.length() && ',' == src[pos]) {
+                    pos += 1;
+                    skip_space(src, pos);
+                }
+            }
+            read_string_array(src, pos, res);
+        }
+    }
+    return res;
+}
+
+class builder {
+    const build_params& params;
+    std::string output_full;
+    std::vector<unit> path_units;
+    std::set<std::string> path_names;
+    zip::writer writer;
+    std::set<std::string> included;
+    std::deque<unit> queue;
+
+public:
+    builder(const build_params& params) :
+    params(params),
+    output_full(full_output_path(params.output)),
+    writer(params.output) {
+        for (auto& fi : params.paths) {
+            auto& url = fi.val().as_string_nonempty_or_throw(fi.name());
+            path_units.emplace_back(path_unit(fi.name(), url));
+            path_names.insert(fi.name());
+        }
+    }
+
+    std::vector<std::string> build() {
+        trace::phase ph("image::build", params.output);
+        enqueue(params.startmod);
+        enqueue(requirejs_package);
+        for (auto& id : params.includes) {
+            enqueue(id);
+        }
+        while (!queue.empty()) {
+            auto un = std::move(queue.front());
+            queue.pop_front();
+            copy_unit(un);
+        }
+        writer.add_entry(manifest_entry_name, sl::json::dumps(create_manifest()));
+        writer.finish();
+        return std::vector<std::string>(included.begin(), included.end());
+    }
+
+private:
+    // output file may not exist yet
+    static std::string full_output_path(const std::string& output) {
+        auto dir = sl::utils::strip_filename(output);
+        auto dir_full = sl::tinydir::full_path(dir.empty() ? std::string(".") : dir);
+        if (!sl::utils::ends_with(dir_full, "/")) {
+            dir_full.push_back('/');
+        }
+        return dir_full + sl::utils::strip_parent_dir(output);
+    }
+
+    // image may be built inside app dir, output, its temp file
+    // and images from previous builds are not included
+    bool is_image_file(const unit& un, const std::string& entry_name, const std::string& rel) const {
+        if (is_image(entry_name)) {
+            return true;
+        }
+        if ("zip" == un.kind) {
+            return false;
+        }
+        auto file = "file" == un.kind ? un.path : un.path + un.prefix + rel;
+        return sl::utils::starts_with(file, output_full);
+    }
+
+    static unit path_unit(const std::string& name, const std::string& url) {
+        auto res = unit();
+        res.name = name;
+        if (sl::utils::starts_with(url, support::zip_proto_prefix)) {
+            res.kind = "zip";
+            res.path = url_path(url, support::zip_proto_prefix);
+        } else if (sl::utils::starts_with(url, support::file_proto_prefix)) {
+            auto path = url_path(url, support::file_proto_prefix);
+            auto dir = sl::tinydir::path(path);
+            if (dir.exists() && dir.is_directory()) {
+                res.kind = "dir";
+                res.path = sl::utils::ends_with(path, "/") ? path : path + "/";
+            } else {
+                // single-file vendor lib, '.js' is appended by loader
+                res.kind = "file";
+                res.path = path + ".js";
+            }
+        } else throw support::exception(TRACEMSG(
+                "Unsupported module URL, name: [" + name + "], url: [" + url + "]"));
+        return res;
+    }
+
+    unit std_unit(const std::string& top) {
+        auto res = unit();
+        res.name = top;
+        res.prefix = top + "/";
+        if (sl::utils::starts_with(params.std_modurl, support::zip_proto_prefix)) {
+            res.kind = "zip";
+            res.path = url_path(params.std_modurl, support::zip_proto_prefix);
+        } else {
+            res.kind = "dir";
+            res.path = url_path(params.std_modurl, support::file_proto_prefix);
+        }
+        return res;
+    }
+
+    // same precedence as in requirejs: longest 'paths' prefix, then baseUrl
+    std::string resolve_unit_name(const std::string& id) const {
+        auto best = std::string();
+        for (auto& name : path_names) {
+            if ((id == name || sl::utils::starts_with(id, name + "/")) && name.length() > best.length()) {
+                best = name;
+            }
+        }
+        if (!best.empty()) {
+            return best;
+        }
+        auto slash = id.find('/');
+        return std::string::npos != slash ? id.substr(0, slash) : id;
+    }
+
+    void enqueue(const std::string& id_with_plugin) {
+        if (id_with_plugin.empty()) {
+            return;
+        }
+        auto excl = id_with_plugin.find('!');
+        if (std::string::npos != excl) {
+            enqueue(id_with_plugin.substr(0, excl));
+            enqueue(id_with_plugin.substr(excl + 1));
+            return;
+        }
+        auto& id = id_with_plugin;
+        // relative IDs stay within already included unit
+        if (sl::utils::starts_with(id, ".") || sl::utils::starts_with(id, "/") ||
+                std::string::npos != id.find("://")) {
+            return;
+        }
+        auto name = resolve_unit_name(id);
+        if (included.end() != included.find(name)) {
+            return;
+        }
+        included.insert(name);
+        if (path_names.end() != path_names.find(name)) {
+            for (auto& un : path_units) {
+                if (name == un.name) {
+                    queue.push_back(un);
+                }
+            }
+        } else {
+            queue.push_back(std_unit(name));
+        }
+    }
+
+    std::vector<std::string> list_files(const unit& un) {
+        if ("file" == un.kind) {
+            return {std::string()};
+        }
+        if ("dir" == un.kind) {
+            return list_dir_recursive(un.path + un.prefix, "");
+        }
+        auto idx = zip::open_index(un.path);
+        auto res = std::vector<std::string>();
+        for (auto& en : idx->get_entries()) {
+            if (sl::utils::starts_with(en, un.prefix) && !sl::utils::ends_with(en, "/")) {
+                res.emplace_back(en.substr(un.prefix.length()));
+            }
+        }
+        return res;
+    }
+
+    std::string read_unit_file(const unit& un, const std::string& rel) {
+        if ("zip" == un.kind) {
+            return read_zip_entry(un.path, un.prefix + rel);
+        }
+        return read_file(un.path + un.prefix + rel);
+    }
+
+    void copy_unit(const unit& un) {
+        trace::phase ph("image::copy", un.name);
+        for (auto& rel : list_files(un)) {
+            auto entry_name = "file" == un.kind ? un.name + ".js" : un.name + "/" + rel;
+            // file is shadowed by a more specific 'paths' entry
+            auto module_id = sl::utils::ends_with(entry_name, ".js") ?
+                    entry_name.substr(0, entry_name.length() - 3) : entry_name;
+            if (un.name != resolve_unit_name(module_id) || writer.contains(entry_name) ||
+                    is_image_file(un, entry_name, rel)) {
+                continue;
+            }
+            auto data = read_unit_file(un, rel);
+            if (sl::utils::ends_with(entry_name, ".js")) {
+                for (auto& id : scan_dependencies(data)) {
+                    enqueue(id);
+                }
+            }
+            writer.add_entry(entry_name, data);
+        }
+    }
+
+    sl::json::value create_manifest() {
+        auto packages = std::vector<sl::json::value>();
+        for (auto& pa : params.packages) {
+            auto& name = pa["name"].as_string();
+            if (included.end() != included.find(name)) {
+                packages.emplace_back(pa.clone());
+            }
+        }
+        auto modules = std::vector<sl::json::value>();
+        for (auto& name : included) {
+            modules.emplace_back(name);
+        }
+        return {
+            {"imageFormatVersion", image_format_version},
+            {"wiltonVersion", params.wilton_version},
+            {"startupModule", params.startmod},
+            {"startupScriptId", params.startmod_id},
+            {"requireJs", {
+                    // all modules are resolved against image baseUrl
+                    {"paths", std::vector<sl::json::field>()},
+                    {"packages", std::move(packages)}
+                }
+            },
+            {"modules", std::move(modules)},
+            {"appConfig", params.app_config.has_value() ?
+                    params.app_config.value().clone() : sl::json::value()}
+        };
+    }
+};
+
+std::vector<std::string> build(const build_params& params) {
+    builder bu(params);
+    return bu.build();
+}
+
+// image is bound to the launcher version it was built with
+manifest read_manifest(const std::string& image_path, const std::string& wilton_version) {
+    trace::phase ph("image::read_manifest", image_path);
+    auto idx = zip::open_index(image_path);
+    if (idx->find_zip_entry(manifest_entry_name).is_empty()) throw support::exception(TRACEMSG(
+            "Invalid application image, '" + manifest_entry_name + "' not found, path: [" + image_path + "]"));
+    auto json = sl::json::loads(read_zip_entry(image_path, manifest_entry_name));
+    auto ctx = image_path + ":" + manifest_entry_name;
+    auto version = json["imageFormatVersion"].as_int64_or_throw(ctx + ":imageFormatVersion");
+    if (image_format_version != version) throw support::exception(TRACEMSG(
+            "Unsupported application image format version: [" + sl::support::to_string(version) + "]," +
+            " expected: [" + sl::support::to_string(image_format_version) + "], path: [" + image_path + "]"));
+    auto& image_version = json["wiltonVersion"].as_string_nonempty_or_throw(ctx + ":wiltonVersion");
+    if (wilton_version != image_version) throw support::exception(TRACEMSG(
+            "Application image was built with a different Wilton version: [" + image_version + "]," +
+            " current: [" + wilton_version + "], path: [" + image_path + "]"));
+    auto res = manifest();
+    res.startmod = json["startupModule"].as_string_nonempty_or_throw(ctx + ":startupModule");
+    res.startmod_id = json["startupScriptId"].as_string_nonempty_or_throw(ctx + ":startupScriptId");
+    auto& rjs = json["requireJs"];
+    for (auto& fi : rjs["paths"].as_object_or_throw(ctx + ":requireJs.paths")) {
+        res.paths.emplace_back(fi.name(), fi.val().clone());
+    }
+    for (auto& pa : rjs["packages"].as_array_or_throw(ctx + ":requireJs.packages")) {
+        res.packages.emplace_back(pa.clone());
+    }
+    auto& conf = json["appConfig"];
+    if (sl::json::type::nullt != conf.json_type()) {
+        res.app_config = sl::support::make_optional(conf.clone());
+    }
+    return res;
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_APP_IMAGE_HPP */
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   batch.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:28 AM
+ */
+
+#ifndef WILTON_CLI_BATCH_HPP
+#define WILTON_CLI_BATCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace cli {
+namespace batch {
+
+struct entry {
+    std::string script;
+    std::vector<std::string> args;
+    size_t line_number = 0;
+};
+
+struct result {
+    std::string script;
+    uint8_t exit_code = 0;
+    int64_t duration_us = 0;
+};
+
+// one JSON object per line: {"script": "path/to/script.js", "args": ["foo"]},
+// empty lines are skipped, '-' reads the list from stdin
+std::vector<entry> read_entries(const std::string& path) {
+    auto file = std::ifstream();
+    if ("-" != path) {
+        file.open(path);
+        if (!file.is_open()) throw support::exception(TRACEMSG(
+                "Cannot open batch file, path: [" + path + "]"));
+    }
+    std::istream& in = "-" != path ? static_cast<std::istream&>(file) : std::cin;
+    auto res = std::vector<entry>();
+    auto line = std::string();
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        line_number += 1;
+        auto trimmed = sl::utils::trim(line);
+        if (trimmed.empty()) {
+            continue;
+        }
+        auto ctx = "batch line " + sl::support::to_string(line_number);
+        auto json = sl::json::loads(trimmed);
+        auto en = entry();
+        en.line_number = line_number;
+        for (auto& fi : json.as_object_or_throw(ctx)) {
+            if ("script" == fi.name()) {
+                en.script = fi.val().as_string_nonempty_or_throw(ctx + ":script");
+                std::replace(en.script.begin(), en.script.end(), '\\', '/');
+            } else if ("args" == fi.name()) {
+                for (auto& ar : fi.val().as_array_or_throw(ctx + ":args")) {
+                    en.args.emplace_back(ar.as_string_or_throw(ctx + ":args"));
+                }
+            } else {
+                throw support::exception(TRACEMSG("Unknown field: [" + fi.name() + "], " + ctx));
+            }
+        }
+        if (en.script.empty()) throw support::exception(TRACEMSG(
+                "Script is not specified, " + ctx));
+        res.emplace_back(std::move(en));
+    }
+    return res;
+}
+
+std::string result_json(const result& re) {
+    return sl::json::dumps({
+        {"script", re.script},
+        {"exitCode", static_cast<int64_t>(re.exit_code)},
+        {"durationMs", static_cast<double>(re.duration_us) / 1000}
+    });
+}
+
+std::string summary_json(const std::vector<result>& results, int64_t total_us) {
+    int64_t failed = 0;
+    for (auto& re : results) {
+        if (0 != re.exit_code) {
+            failed += 1;
+        }
+    }
+    return sl::json::dumps({
+        {"batch", {
+            {"scripts", static_cast<int64_t>(results.size())},
+            {"failed", failed},
+            {"totalMs", static_cast<double>(total_us) / 1000}
+        }}
+    });
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_BATCH_HPP */
@@ -22,10 +22,17 @@
  * Created on June 6, 2017, 6:31 PM
  */
 
+#include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <array>
+#include <chrono>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -57,9 +64,28 @@ extern char** environ;
 #include "wilton/support/exception.hpp"
 #include "wilton/support/misc.hpp"
 
+#include "allocator.hpp"
+#include "app_image.hpp"
+#include "batch.hpp"
 #include "cli_options.hpp"
+#include "crypt_cache.hpp"
+#include "env_filter.hpp"
 #include "ghc_init.hpp"
+#include "inline_script.hpp"
 #include "jvm_engine.hpp"
+#include "jvm_server.hpp"
+#include "lib_manifest.hpp"
+#include "metrics.hpp"
+#include "placement.hpp"
+#include "readahead.hpp"
+#include "remote_launch.hpp"
+#include "startup_cache.hpp"
+#include "startup_tasks.hpp"
+#include "startup_trace.hpp"
+#include "supervisor.hpp"
+#include "watch.hpp"
+#include "zip_index.hpp"
+#include "zygote.hpp"
 
 #define WILTON_QUOTE(value) #value
 #define WILTON_STR(value) WILTON_QUOTE(value)
@@ -83,14 +109,31 @@ int find_launcher_args_end(int argc, char** argv) {
     return argc;
 }
 
+std::map<std::string, sl::json::value>& loaded_app_configs() {
+    static std::map<std::string, sl::json::value> loaded;
+    return loaded;
+}
+
+// config frozen into application image is used instead of 'conf/config.json'
+void register_app_config(const std::string& appdir, const sl::json::value& config) {
+    loaded_app_configs()[appdir] = config.clone();
+}
+
 sl::support::optional<sl::json::value> load_app_config(const std::string& appdir) {
+    // config is parsed once per launch, callers get their own copies
+    auto& loaded = loaded_app_configs();
     if (!appdir.empty()) {
+        auto it = loaded.find(appdir);
+        if (loaded.end() != it) {
+            return sl::support::make_optional(it->second.clone());
+        }
         auto pconf = sl::tinydir::path(appdir + "conf/");
         if (pconf.exists()) {
             auto cfile = sl::tinydir::path(appdir + "conf/config.json");
             if (cfile.exists() && !cfile.is_directory()) {
                 auto src = cfile.open_read();
                 auto val = sl::json::load(src);
+                loaded.insert(std::make_pair(appdir, val.clone()));
                 return sl::support::make_optional(std::move(val));
             }
         }
@@ -145,51 +188,75 @@ char platform_delimiter(const std::string& arg) {
     return delim;
 }
 
-std::vector<sl::json::field> prepare_paths(const std::string& wilton_home,
+std::string resolve_binary_module(const std::string& mod,
+        const sl::support::optional<wilton::cli::libs::manifest>& manifest, const std::string& cwd) {
+    if (!sl::utils::ends_with(mod, wilton::support::binmod_postfix)) {
+        throw wilton::support::exception(TRACEMSG("Invalid binary module path specified," +
+                " must be 'path/to/mymod.wlib', path: [" + mod + "]"));
+    }
+    if (manifest.has_value()) {
+        auto indexed = manifest.value().find_binary_module(mod, cwd);
+        if (!indexed.empty()) {
+            return indexed;
+        }
+    }
+    auto modpath = sl::tinydir::path(mod);
+    if (!(modpath.exists() && modpath.is_regular_file())) {
+        throw wilton::support::exception(TRACEMSG("Binary module file not found," +
+                " path: [" + mod + "]"));
+    }
+    return sl::tinydir::full_path(mod);
+}
+
+// binary modules are mapped under the startup module name
+void append_binary_modules_paths(std::vector<sl::json::field>& res,
         const std::string& binary_modules_paths, const std::string& startmod,
-        const std::string& startmod_dir) {
-    std::vector<sl::json::field> res;
-    // startup module
-    res.emplace_back(startmod, wilton::support::file_proto_prefix + startmod_dir);
-    // binary modules
+        const sl::support::optional<wilton::cli::libs::manifest>& manifest) {
     auto binmods = sl::utils::split(binary_modules_paths, platform_delimiter(binary_modules_paths));
+    auto cwd = binmods.empty() || !manifest.has_value() ? std::string() : wilton::cli::current_directory();
     for(auto& mod : binmods) {
-        if (!sl::utils::ends_with(mod, wilton::support::binmod_postfix)) {
-            throw wilton::support::exception(TRACEMSG("Invalid binary module path specified," +
-                    " must be 'path/to/mymod.wlib', path: [" + mod + "]"));
-        }
-        auto modpath = sl::tinydir::path(mod);
-        if (!(modpath.exists() && modpath.is_regular_file())) {
-            throw wilton::support::exception(TRACEMSG("Binary module file not found," +
-                    " path: [" + mod + "]"));
-        }
+        auto modfullpath = resolve_binary_module(mod, manifest, cwd);
         auto modfile = sl::utils::strip_parent_dir(mod);
         auto modsubname = modfile.substr(0, modfile.length() - wilton::support::binmod_postfix.length());
         auto modname = startmod + "/" + modsubname;
-        auto modfullpath = sl::tinydir::full_path(mod);
         res.emplace_back(modname, wilton::support::zip_proto_prefix + modfullpath);
     }
+}
+
+std::vector<sl::json::field> prepare_paths(const std::string& wilton_home,
+        const std::string& binary_modules_paths, const std::string& startmod,
+        const std::string& startmod_dir) {
+    wilton::cli::trace::phase ph("prepare_paths");
+    std::vector<sl::json::field> res;
+    auto manifest = wilton::cli::libs::load_manifest(wilton_home);
+    // startup module
+    res.emplace_back(startmod, wilton::support::file_proto_prefix + startmod_dir);
+    // binary modules
+    append_binary_modules_paths(res, binary_modules_paths, startmod, manifest);
     // vendor libs
-    auto libdir = sl::tinydir::path(wilton_home + "/lib");
-    if (libdir.exists()) {
-        for (sl::tinydir::path& libpath : sl::tinydir::list_directory(libdir.filepath())) {
-            if (libpath.is_directory()) {
-                auto& modname = libpath.filename();
-                res.emplace_back(modname, wilton::support::file_proto_prefix + libpath.filepath());
-            } else if (sl::utils::ends_with(libpath.filename(), ".js")) {
-                const auto& modname = libpath.filename().substr(0, libpath.filename().length() - 3);
-                const auto& dirpath = sl::utils::strip_filename(libpath.filepath());
-                res.emplace_back(modname, wilton::support::file_proto_prefix + dirpath + modname);
-            } else if (sl::utils::ends_with(libpath.filename(), ".wlib")) {
-                const auto& modname = libpath.filename().substr(0, libpath.filename().length() - 5);
-                res.emplace_back(modname, wilton::support::zip_proto_prefix + libpath.filepath());
-            }
-        }
+    auto vendor = manifest.has_value() ? std::move(manifest.value().modules) :
+            wilton::cli::libs::scan_lib_dir(wilton_home + "lib");
+    for (auto& fi : vendor) {
+        res.emplace_back(std::move(fi));
     }
     return res;
 }
 
+uint8_t run_index_libs(const wilton::cli::cli_options& opts, const std::string& wilton_home) {
+    auto binmods = sl::utils::split(opts.binary_modules_paths, platform_delimiter(opts.binary_modules_paths));
+    auto resolved = std::vector<std::pair<std::string, std::string>>();
+    auto no_manifest = sl::support::optional<wilton::cli::libs::manifest>();
+    for (auto& mod : binmods) {
+        auto modfullpath = resolve_binary_module(mod, no_manifest, std::string());
+        resolved.emplace_back(mod, modfullpath);
+    }
+    auto path = wilton::cli::libs::write_manifest(wilton_home, resolved);
+    std::cout << "Lib manifest written: [" << path << "]" << std::endl;
+    return 0;
+}
+
 void dyload_module(const std::string& name) {
+    wilton::cli::trace::phase ph("dyload_module", name);
     auto err_dyload = wilton_dyload(name.c_str(), static_cast<int>(name.length()), nullptr, 0);
     if (nullptr != err_dyload) {
         wilton::support::throw_wilton_error(err_dyload, TRACEMSG(err_dyload));
@@ -197,6 +264,7 @@ void dyload_module(const std::string& name) {
 }
 
 void init_signals() {
+    wilton::cli::trace::phase ph("init_signals");
     dyload_module("wilton_signal");
     auto err_init = wilton_signal_initialize();
     if (nullptr != err_init) {
@@ -219,17 +287,18 @@ sl::json::value read_json_file(const std::string& url) {
 sl::json::value read_json_zip_entry(const std::string& zip_url, const std::string& entry) {
     dyload_module("wilton_zip");
     auto zip_path = zip_url.substr(wilton::support::zip_proto_prefix.length());
-    auto idx = sl::unzip::file_index(zip_path);
-    sl::unzip::file_entry en = idx.find_zip_entry(entry);
+    auto idx = wilton::cli::zip::open_index(zip_path);
+    sl::unzip::file_entry en = idx->find_zip_entry(entry);
     if (en.is_empty()) throw wilton::support::exception(TRACEMSG(
-            "Unable to load 'wilton-packages.json', ZIP entry: [" + entry + "]," +
+            "Unable to load JSON, ZIP entry: [" + entry + "]," +
             " file: [" + zip_path + "]"));
-    auto stream = sl::unzip::open_zip_entry(idx, entry);
+    auto stream = sl::unzip::open_zip_entry(*idx, entry);
     auto src = sl::io::streambuf_source(stream->rdbuf());
     return sl::json::load(src);
 }
 
 std::vector<sl::json::value> load_packages_list(const std::string& modurl) {
+    wilton::cli::trace::phase ph("load_packages_list");
     // note: cannot use 'wilton_loader' here, as it is not initialized yet
     auto packages_json_id = "wilton-requirejs/wilton-packages.json";
     auto res = sl::json::value();
@@ -258,6 +327,7 @@ std::string get_env_var_value(const std::vector<std::string>& parts) {
 }
 
 void set_env_vars(const std::string& environment_vars) {
+    wilton::cli::trace::phase ph("set_env_vars");
     auto vars = sl::utils::split(environment_vars, platform_delimiter(environment_vars));
     for (auto& var : vars) {
         auto parts = sl::utils::split(var, '=');
@@ -278,7 +348,9 @@ void set_env_vars(const std::string& environment_vars) {
     }
 }
 
-std::vector<sl::json::field> collect_env_vars() {
+// variables not matching non-empty allowlist are skipped before copying
+std::vector<sl::json::field> collect_env_vars(const std::vector<std::string>& allow) {
+    wilton::cli::trace::phase ph("collect_env_vars");
 #ifdef STATICLIB_WINDOWS
     auto envp = _environ;
 #else // !STATICLIB_WINDOWS
@@ -286,6 +358,13 @@ std::vector<sl::json::field> collect_env_vars() {
 #endif
     auto vec = std::vector<sl::json::field>();
     for (char** el = envp; *el != nullptr; el++) {
+        if (!allow.empty()) {
+            auto eq = std::strchr(*el, '=');
+            if (nullptr == eq || !wilton::cli::env::is_allowed(allow,
+                    sl::utils::trim(std::string(*el, static_cast<size_t>(eq - *el))))) {
+                continue;
+            }
+        }
         auto var = std::string(*el);
         auto parts = sl::utils::split(var, '=');
         if (parts.size() >= 2) {
@@ -304,72 +383,6 @@ std::vector<sl::json::field> collect_env_vars() {
     return vec;
 }
 
-std::string write_temp_one_liner(const std::string& deps, const std::string& code) {
-    // prepare tmp file path
-    auto rsg = sl::utils::random_string_generator();
-    auto name = "wilton_" + rsg.generate(8) + ".js";
-#ifdef STATICLIB_WINDOWS
-    auto wbuf = std::wstring();
-    wbuf.resize(MAX_PATH + 1);
-    auto len = ::GetTempPathW(static_cast<DWORD>(wbuf.length()), std::addressof(wbuf.front()));
-    // note: unlikely failure to obtain temp dir may be ignored for one-liner purposes
-    wbuf.resize(len);
-    auto dir = sl::utils::narrow(wbuf);
-    auto path_str = dir + "\\" + name;
-#else // !STATICLIB_WINDOWS
-    auto path_str = "/tmp/" + name;
-#endif // STATICLIB_WINDOWS
-    auto path = sl::tinydir::path(path_str);
-
-    // prepare deps
-    auto deps_line = std::string();
-    auto args_line = std::string();
-    if (deps.length() > 0) {
-        auto parts = sl::utils::split(deps, ':');
-        for (size_t i = 0; i < parts.size(); i++) {
-            auto dep = parts.at(i);
-            if (dep.length() > 0) {
-                deps_line.append("\"").append(dep).append("\"");
-                if (i < parts.size() - 1) {
-                    deps_line.append(", ");
-                }
-                auto dep_parts = sl::utils::split(dep, '/');
-                if (dep_parts.size() > 0) {
-                    auto dep_name = dep_parts.back();
-                    args_line.append(dep_name);
-                    if (i < parts.size() - 1) {
-                        args_line.append(", ");
-                    }
-                }
-            }
-        }
-    }
-
-    std::string tmpl = R"(
-define([{{deps_line}}], function({{args_line}}) {
-    "use strict";
-    return {
-        main: function() {
-            var RESULT = {{code}};
-            print(RESULT);
-        }
-    };
-});)";
-
-    // load and format template
-    auto tmpl_src = sl::io::array_source(tmpl.data(), tmpl.length());
-    auto src = sl::io::make_replacer_source(tmpl_src, {
-        {"deps_line", deps_line},
-        {"args_line", args_line},
-        {"code", code}
-    }, [](const std::string& err) {
-        std::cerr << err << std::endl;
-    });
-    auto sink = path.open_write();
-    sl::io::copy_all(src, sink);
-    return path_str;
-}
-
 std::string choose_default_engine(const std::string& opts_script_engine_name, const std::string& debug_port) {
     if (!debug_port.empty() && !opts_script_engine_name.empty() && "duktape" != opts_script_engine_name) {
         std::cerr << "ERROR: only 'duktape' JS engine can be used for debugging" <<
@@ -421,8 +434,12 @@ void load_pre_engine_libs(const wilton::cli::cli_options& opts, const std::strin
     dyload_module("wilton_logging");
     if (!opts.crypt_call_lib.empty()) {
         dyload_module(opts.crypt_call_lib);
+        if (0 != opts.crypt_cache) {
+            wilton::cli::crypt::register_cached_call(opts.crypt_call_name);
+        }
     }
     auto name = std::string("wilton_loader");
+    wilton::cli::trace::phase ph("dyload_module", name);
     auto err = wilton_dyload(name.c_str(), static_cast<int>(name.length()), nullptr, 0);
     if (nullptr != err) {
         report_loader_error(appdir);
@@ -430,15 +447,88 @@ void load_pre_engine_libs(const wilton::cli::cli_options& opts, const std::strin
     }
 }
 
-void load_script_engine(const std::string& script_engine,
-        const std::string& wilton_home, const std::string& modurl,
-        const std::vector<std::pair<std::string, std::string>>& env_vars) {
+JavaVM* load_script_engine(const std::string& script_engine, const std::string& modurl,
+        const std::vector<std::pair<std::string, std::string>>& env_vars,
+        const std::vector<std::string>& jvm_options,
+        wilton::cli::jvm::JNI_CreateJavaVM_type jvm_preloaded = nullptr) {
+    wilton::cli::trace::phase ph("load_script_engine", script_engine);
     if ("rhino" != script_engine && "nashorn" != script_engine) {
         dyload_module("wilton_" + script_engine);
+        return nullptr;
     } else {
-        auto exedir = wilton_home + "bin/";
-        wilton::cli::jvm::load_engine(script_engine, exedir, modurl, env_vars);
+        return wilton::cli::jvm::load_engine(script_engine, jvm_options, modurl, env_vars, jvm_preloaded);
+    }
+}
+
+std::vector<std::string> collect_jvm_options(const wilton::cli::cli_options& opts,
+        const std::string& wilton_home, const std::string& appdir,
+        const std::vector<std::pair<std::string, std::string>>& env_vars) {
+    auto user = std::vector<std::string>();
+    // app config first, command line options can override them
+    auto conf = load_app_config(appdir);
+    if (conf.has_value()) {
+        auto& json = conf.value();
+        auto& jvm_opts = json["jvmOptions"];
+        if (sl::json::type::nullt != jvm_opts.json_type()) {
+            for (auto& opt : jvm_opts.as_array_or_throw("conf/config.json:jvmOptions")) {
+                user.emplace_back(opt.as_string_nonempty_or_throw("conf/config.json:jvmOptions"));
+            }
+        }
+    }
+    for (auto& opt : opts.jvm_options) {
+        user.emplace_back(opt);
+    }
+    // CDS options go before user ones, so '-Xshare:off' can be used to disable it
+    auto base = wilton::cli::jvm::vm_options(wilton_home + "bin/", env_vars, std::vector<std::string>());
+    auto archive = wilton::cli::jvm::cds_archive_path(wilton_home, base, env_vars);
+    auto cds = wilton::cli::jvm::cds_options(archive, 0 != opts.jvm_cds_dump);
+    cds.insert(cds.end(), user.begin(), user.end());
+    return wilton::cli::jvm::vm_options(wilton_home + "bin/", env_vars, cds);
+}
+
+std::vector<std::pair<std::string, std::string>> env_vars_to_pairs(
+        const std::vector<sl::json::field>& env_vars) {
+    auto res = std::vector<std::pair<std::string, std::string>>();
+    for (auto& fi : env_vars) {
+        res.emplace_back(fi.name(), fi.as_string_or_throw(fi.name()));
     }
+    return res;
+}
+
+std::vector<std::string> collect_env_allow(const wilton::cli::cli_options& opts, const std::string& appdir) {
+    auto res = wilton::cli::env::parse_patterns(opts.env_allow);
+    auto conf = load_app_config(appdir);
+    if (conf.has_value()) {
+        auto& json = conf.value();
+        auto& allow = json["envAllow"];
+        if (sl::json::type::nullt != allow.json_type()) {
+            for (auto& pat : allow.as_array_or_throw("conf/config.json:envAllow")) {
+                res.emplace_back(pat.as_string_nonempty_or_throw("conf/config.json:envAllow"));
+            }
+        }
+    }
+    return res;
+}
+
+// JVM is started with full environment, other engines
+// only need the variables that are passed to the app
+std::future<std::vector<sl::json::field>> launch_env_task(const wilton::cli::cli_options& opts,
+        const std::string& script_engine, const std::vector<std::string>& env_allow) {
+    auto is_jvm = "rhino" == script_engine || "nashorn" == script_engine;
+    auto allow = is_jvm ? std::vector<std::string>() : env_allow;
+    return wilton::cli::tasks::launch<std::vector<sl::json::field>>(0 != opts.startup_serial, [allow] {
+        return collect_env_vars(allow);
+    });
+}
+
+wilton::cli::jvm::JNI_CreateJavaVM_type preload_jvm() {
+    // only JAVA_HOME is needed to locate libjvm, full env snapshot may be not ready yet
+    auto env = std::vector<std::pair<std::string, std::string>>();
+    auto java_home = std::getenv("JAVA_HOME");
+    if (nullptr != java_home) {
+        env.emplace_back("JAVA_HOME", std::string(java_home));
+    }
+    return wilton::cli::jvm::load_jvm(env);
 }
 
 sl::support::optional<uint8_t> parse_exit_code(sl::io::span<char> span) {
@@ -482,6 +572,7 @@ std::string create_wilton_config(const wilton::cli::cli_options& opts,
         std::vector<sl::json::field> paths, std::vector<sl::json::value> packages,
         std::vector<sl::json::field> env_vars, const std::string& debug_port,
         const std::string& startup_call) {
+    wilton::cli::trace::phase ph("create_wilton_config");
     auto config = sl::json::dumps({
         {"defaultScriptEngine", script_engine},
         {"wiltonExecutable", wilton_exec},
@@ -509,7 +600,7 @@ std::string create_wilton_config(const wilton::cli::cli_options& opts,
 #endif // OS
         {"debugConnectionPort", debug_port},
         {"traceEnable", 0 != opts.trace_enable},
-        {"cryptCall", opts.crypt_call_name}
+        {"cryptCall", 0 != opts.crypt_cache ? wilton::cli::crypt::cached_call_name : opts.crypt_call_name}
     });
     if (0 != opts.print_config) {
         std::cout << startup_call << std::endl;
@@ -518,12 +609,389 @@ std::string create_wilton_config(const wilton::cli::cli_options& opts,
     return config;
 }
 
+// malloc settings from command line and 'conf/config.json', config
+// is only looked up for plain script files, there are no threads yet
+wilton::cli::allocator::settings prepare_allocator(const wilton::cli::cli_options& opts,
+        const std::string& wilton_home, char** argv) {
+    auto cli = wilton::cli::allocator::settings();
+    cli.arenas = opts.malloc_arenas;
+    cli.trim_threshold = opts.malloc_trim_threshold;
+    cli.mmap_threshold = opts.malloc_mmap_threshold;
+    cli.thp = opts.thp;
+    cli.preload = opts.allocator;
+    cli.report_rss = 0 != opts.report_rss;
+    auto res = cli;
+    auto script = sl::tinydir::path(opts.startup_script);
+    if (0 == opts.exec_one_liner && script.exists() && script.is_regular_file() &&
+            !wilton::cli::image::is_image(opts.startup_script)) {
+        auto appdir = sl::utils::strip_filename(sl::tinydir::full_path(opts.startup_script));
+        auto conf = load_app_config(appdir);
+        if (conf.has_value()) {
+            auto& json = conf.value();
+            res = wilton::cli::allocator::merge(cli, json["allocator"]);
+        }
+    } else {
+        res = wilton::cli::allocator::merge(cli, sl::json::value());
+    }
+    wilton::cli::allocator::reexec_if_needed(res, wilton_home, argv);
+    wilton::cli::allocator::apply(res);
+    return res;
+}
+
+// files in the order they are opened during startup
+std::vector<std::string> collect_readahead_files(const wilton::cli::cli_options& opts,
+        const std::string& wilton_home) {
+    auto res = std::vector<std::string>();
+    // zygote and workers fork when the process must be single-threaded
+    if (0 != opts.startup_serial || !opts.zygote.empty() || !opts.zygote_connect.empty() ||
+            0 != opts.index_libs || 0 != opts.build_image || 0 != opts.ghc_init || opts.workers > 0) {
+        return res;
+    }
+    namespace ra = wilton::cli::readahead;
+    res.emplace_back(ra::module_path(wilton_home, "wilton_logging"));
+    if (!opts.crypt_call_lib.empty()) {
+        res.emplace_back(ra::module_path(wilton_home, opts.crypt_call_lib));
+    }
+    res.emplace_back(ra::module_path(wilton_home, "wilton_loader"));
+    res.emplace_back(!opts.modules_dir_or_zip.empty() ? opts.modules_dir_or_zip : wilton_home + "std.wlib");
+    auto engine = !opts.script_engine_name.empty() ? opts.script_engine_name :
+            !opts.debug_port.empty() ? std::string("duktape") : std::string(WILTON_DEFAULT_SCRIPT_ENGINE_STR);
+    if ("rhino" == engine || "nashorn" == engine) {
+        auto java_home = std::getenv("JAVA_HOME");
+        if (nullptr != java_home) {
+            try {
+                auto env = std::vector<std::pair<std::string, std::string>>();
+                env.emplace_back("JAVA_HOME", std::string(java_home));
+                res.emplace_back(wilton::cli::jvm::find_libjvm_dir(env) + wilton::cli::jvm::libjvm_name);
+            } catch (const std::exception&) {
+                // reported when JVM is loaded
+            }
+        }
+    } else {
+        res.emplace_back(ra::module_path(wilton_home, "wilton_" + engine));
+        res.emplace_back(ra::module_path(wilton_home, "wilton_signal"));
+    }
+    for (auto& mod : sl::utils::split(opts.binary_modules_paths, platform_delimiter(opts.binary_modules_paths))) {
+        res.emplace_back(mod);
+    }
+    return res;
+}
+
+// CPU, memory and scheduling settings from command line and 'conf/config.json'
+sl::json::value apply_placement(const wilton::cli::cli_options& opts, const std::string& appdir) {
+    auto cli = wilton::cli::placement::settings();
+    cli.cpu_affinity = opts.cpu_affinity;
+    cli.numa_node = opts.numa_node;
+    cli.mlockall = 0 != opts.mlockall;
+    cli.sched_policy = opts.sched_policy;
+    cli.sched_priority = opts.sched_priority;
+    auto conf = load_app_config(appdir);
+    if (conf.has_value()) {
+        auto& json = conf.value();
+        return wilton::cli::placement::apply(wilton::cli::placement::merge(cli, json["placement"]));
+    }
+    return wilton::cli::placement::apply(cli);
+}
+
+void print_launcher_config(const wilton::cli::cache::startup_cache* cache,
+        const std::vector<std::string>& jvm_options, const sl::json::value& placement) {
+    auto fields = std::vector<sl::json::field>();
+    if (nullptr != cache) {
+        fields.emplace_back("startupCache", cache->status());
+    }
+    if (sl::json::type::nullt != placement.json_type()) {
+        fields.emplace_back("placement", placement.clone());
+    }
+    if (!jvm_options.empty()) {
+        auto vec = std::vector<sl::json::value>();
+        for (auto& opt : jvm_options) {
+            vec.emplace_back(opt);
+        }
+        fields.emplace_back("jvmOptions", std::move(vec));
+    }
+    if (!fields.empty()) {
+        std::cout << sl::json::dumps(std::move(fields)) << std::endl;
+    }
+}
+
+std::string make_startup_call(bool load_only, bool es_module, const std::string& startmod_id,
+        const std::string& startjs_full, const std::vector<std::string>& appargs) {
+    // prepare args
+    auto args_json = std::vector<sl::json::value>();
+    for (auto& st : appargs) {
+        args_json.emplace_back(st);
+    }
+
+    // startup call
+    if (load_only) {
+        return sl::json::dumps({
+            {"module", startmod_id}
+        });
+    } else if (es_module) {
+        return sl::json::dumps({
+            {"esmodule", "file://" + startjs_full},
+            {"args", std::move(args_json)}
+        });
+    } else {
+        return sl::json::dumps({
+            {"module", startmod_id},
+            {"func", "main"}, // optional, kept for compat
+            {"args", std::move(args_json)}
+        });
+    }
+}
+
+// started after signals are initialized, nothing is created when option is not set
+std::unique_ptr<wilton::cli::metrics::exporter> start_metrics(const wilton::cli::cli_options& opts) {
+    auto res = std::unique_ptr<wilton::cli::metrics::exporter>();
+    if (opts.metrics.empty()) {
+        return res;
+    }
+    auto target = opts.metrics;
+    // each worker gets its own socket or file
+    auto worker_id = std::getenv(wilton::cli::supervisor::worker_id_env_var.c_str());
+    if (nullptr != worker_id) {
+        target += std::string(".") + worker_id;
+    }
+    res.reset(new wilton::cli::metrics::exporter(target, static_cast<uint32_t>(opts.metrics_interval)));
+    res->start();
+    return res;
+}
+
+uint8_t call_startup_script(const std::string& script_engine, const std::string& startup_call) {
+    char* out = nullptr;
+    int out_len = 0;
+    char* err_run = [&] {
+        wilton::cli::trace::phase ph("wiltoncall_runscript");
+        return wiltoncall_runscript(script_engine.c_str(), static_cast<int>(script_engine.length()),
+                startup_call.c_str(), static_cast<int> (startup_call.length()), &out, &out_len);
+    }();
+    auto outcleaner = sl::support::defer([out]() STATICLIB_NOEXCEPT {
+        wilton_free(out);
+    });
+    if (nullptr != err_run) {
+        std::cerr << "ERROR: " << err_run << std::endl;
+        wilton_free(err_run);
+        return 1;
+    } else if (out_len > 0) {
+        auto opt = parse_exit_code({out, out_len});
+        if (opt.has_value()) {
+            return opt.value();
+        } // pass through
+    }
+    return 0;
+}
+
+// module ID for a script from the startup module directory
+std::string script_module_id(const std::string& startmod, const std::string& startmod_dir,
+        const std::string& script_full) {
+    if (!sl::utils::starts_with(script_full, startmod_dir)) throw wilton::support::exception(TRACEMSG(
+            "Script must be located under the startup module directory," +
+            " script: [" + script_full + "], directory: [" + startmod_dir + "]"));
+    auto rel = script_full.substr(startmod_dir.length());
+    if (sl::utils::ends_with(rel, ".js")) {
+        rel = rel.substr(0, rel.length() - 3);
+    }
+    return startmod + "/" + rel;
+}
+
+uint8_t run_zygote(const wilton::cli::cli_options& opts, const std::string& script_engine,
+        const std::string& startmod, const std::string& startmod_dir, const std::string& startmod_id) {
+    // warm up engine and requirejs on the main thread, jobs are forked from it
+    auto warmup_call = make_startup_call(true, false, startmod_id, std::string(), std::vector<std::string>());
+    auto warmup_code = call_startup_script(script_engine, warmup_call);
+    if (0 != warmup_code) {
+        return warmup_code;
+    }
+
+    wilton::cli::zygote::serve(opts.zygote, [&](const wilton::cli::remote::request& req) -> uint8_t {
+        auto script_full = sl::tinydir::full_path(req.script);
+        auto module_id = script_module_id(startmod, startmod_dir, script_full);
+        auto startup_call = make_startup_call(false, check_es_module(script_full),
+                module_id, script_full, req.args);
+        init_signals();
+        return call_startup_script(script_engine, startup_call);
+    });
+    return 0;
+}
+
+uint8_t run_jvm_server(const wilton::cli::cli_options& opts, const std::string& script_engine,
+        const std::string& startmod, const std::string& startmod_dir, const std::string& startmod_id) {
+    // warm up engine and requirejs, JIT-compiled code is shared by all job threads
+    auto warmup_call = make_startup_call(true, false, startmod_id, std::string(), std::vector<std::string>());
+    auto warmup_code = call_startup_script(script_engine, warmup_call);
+    if (0 != warmup_code) {
+        return warmup_code;
+    }
+
+    wilton::cli::jvm_server::serve(opts.jvm_server, [&](const wilton::cli::remote::request& req) -> uint8_t {
+        auto script_full = sl::tinydir::full_path(req.script);
+        auto module_id = script_module_id(startmod, startmod_dir, script_full);
+        auto startup_call = make_startup_call(false, false, module_id, script_full, req.args);
+        return call_startup_script(script_engine, startup_call);
+    });
+    return 0;
+}
+
+// binary modules from '-b' option, mapped under the startup module name
+std::vector<wilton::cli::watch::binmod> collect_watched_binmods(const std::vector<sl::json::field>& paths,
+        const std::string& startmod) {
+    auto res = std::vector<wilton::cli::watch::binmod>();
+    for (auto& fi : paths) {
+        auto& url = fi.val().as_string();
+        if (sl::utils::starts_with(fi.name(), startmod + "/") &&
+                sl::utils::starts_with(url, wilton::support::zip_proto_prefix)) {
+            auto bm = wilton::cli::watch::binmod();
+            bm.path = url.substr(wilton::support::zip_proto_prefix.length());
+            bm.name = fi.name();
+            res.emplace_back(std::move(bm));
+        }
+    }
+    return res;
+}
+
+// encrypted bundles are the '-b' modules mapped under startup
+// modules, vendor libs and std modules are not decrypted eagerly
+std::vector<std::string> collect_crypt_bundles(const wilton::cli::cli_options& opts,
+        const std::vector<sl::json::field>& paths) {
+    auto res = std::vector<std::string>();
+    if (0 == opts.crypt_cache) {
+        return res;
+    }
+    for (auto& fi : paths) {
+        auto& url = fi.val().as_string();
+        if (std::string::npos != fi.name().find('/') &&
+                sl::utils::starts_with(url, wilton::support::zip_proto_prefix)) {
+            res.emplace_back(url.substr(wilton::support::zip_proto_prefix.length()));
+        }
+    }
+    return res;
+}
+
+// runs concurrently with engine loading, must be joined before fork
+std::unique_ptr<wilton::cli::crypt::prefiller> start_crypt_prefill(const wilton::cli::cli_options& opts,
+        const std::vector<std::string>& bundles) {
+    if (bundles.empty()) {
+        return std::unique_ptr<wilton::cli::crypt::prefiller>();
+    }
+    return std::unique_ptr<wilton::cli::crypt::prefiller>(new wilton::cli::crypt::prefiller(
+            bundles, static_cast<uint32_t>(opts.crypt_threads)));
+}
+
+// runtime and engine stay initialized, changed modules and their
+// dependents are undefined in requirejs and the script is called again
+uint8_t run_watch(const std::string& script_engine, const std::string& startmod,
+        const std::string& startmod_dir, const std::string& startmod_id,
+        const std::vector<wilton::cli::watch::binmod>& binmods, const std::string& startup_call) {
+    namespace wt = wilton::cli::watch;
+    wt::dependency_graph graph(startmod, startmod_dir);
+    wt::watcher watcher(startmod_dir, binmods);
+    auto helper = wilton::cli::inline_script::script();
+    helper.source = wt::invalidate_module_source;
+    wilton::cli::inline_script::temp_module helper_module(helper, "wilton_watch");
+    auto& helper_path = helper_module.path();
+    for (;;) {
+        std::cerr << "Watching for changes, press Ctrl+C to exit" << std::endl;
+        // default handlers while waiting, so Ctrl+C stops the process
+        auto prev_int = std::signal(SIGINT, SIG_DFL);
+        auto prev_term = std::signal(SIGTERM, SIG_DFL);
+        auto ch = watcher.wait(std::chrono::milliseconds(100));
+        std::signal(SIGINT, prev_int);
+        std::signal(SIGTERM, prev_term);
+
+        // startup module is always re-evaluated
+        auto ids = std::set<std::string>();
+        ids.insert(startmod_id);
+        auto prefixes = std::vector<std::string>();
+        for (auto& pa : ch.paths) {
+            graph.update(pa);
+            auto id = graph.module_id(pa);
+            if (!id.empty()) {
+                ids.insert(id);
+            }
+            for (auto& bm : binmods) {
+                if (pa == bm.path) {
+                    prefixes.emplace_back(bm.name);
+                    for (auto& bid : wt::binary_module_ids(bm)) {
+                        ids.insert(bid);
+                    }
+                }
+            }
+        }
+        auto invalidated = graph.dependents(ids, prefixes);
+        auto ids_json = std::vector<sl::json::value>();
+        for (auto& id : invalidated) {
+            ids_json.emplace_back(id);
+        }
+        auto args_json = std::vector<sl::json::value>();
+        args_json.emplace_back(std::move(ids_json));
+        auto undef_call = sl::json::dumps({
+            {"module", "file://" + helper_path},
+            {"func", "undef"},
+            {"args", std::move(args_json)}
+        });
+        auto rescode = call_startup_script(script_engine, undef_call);
+        if (0 == rescode) {
+            rescode = call_startup_script(script_engine, startup_call);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - ch.first_event);
+        std::cerr << "Reloaded, changed files: [" << ch.paths.size() << "]," <<
+                " invalidated modules: [" << invalidated.size() << "]," <<
+                " exit code: [" << static_cast<int>(rescode) << "]," <<
+                " time: [" << elapsed.count() << "] ms" << std::endl;
+    }
+}
+
+std::unique_ptr<wilton::cli::cache::startup_cache> create_startup_cache(
+        const wilton::cli::cli_options& opts, const std::string& wilton_home,
+        const std::string& modurl, const std::string& startjs_full, const std::string& appdir) {
+    auto dir = sl::tinydir::path(opts.startup_cache);
+    if (!dir.exists()) {
+        sl::tinydir::create_directory(opts.startup_cache);
+    }
+    // key selects the cache file, fingerprint validates its contents
+    auto key = startjs_full + "\n" + opts.startup_module_name + "\n" +
+            opts.binary_modules_paths + "\n" + modurl;
+    auto files = std::vector<std::string>();
+    if (sl::utils::starts_with(modurl, wilton::support::zip_proto_prefix)) {
+        files.emplace_back(modurl.substr(wilton::support::zip_proto_prefix.length()));
+    } else {
+        files.emplace_back(modurl.substr(wilton::support::file_proto_prefix.length()) +
+                "wilton-requirejs/wilton-packages.json");
+    }
+    files.emplace_back(wilton_home + "lib");
+    files.emplace_back(appdir + "conf/config.json");
+    auto binmods = sl::utils::split(opts.binary_modules_paths,
+            platform_delimiter(opts.binary_modules_paths));
+    for (auto& mod : binmods) {
+        files.emplace_back(mod);
+    }
+    auto fingerprint = wilton::cli::cache::fingerprint({
+        WILTON_VERSION_STR,
+        wilton::cli::current_directory()
+    }, files);
+    return std::unique_ptr<wilton::cli::cache::startup_cache>(
+            new wilton::cli::cache::startup_cache(opts.startup_cache, key, fingerprint));
+}
+
 uint8_t run_new_project(const wilton::cli::cli_options& opts,
         const std::string& script_engine, const std::string& wilton_exec,
         const std::string& wilton_home, const std::string& modurl,
-        std::vector<sl::json::value> packages, const std::string& debug_port,
-        std::vector<sl::json::field> env_vars,
-        const std::vector<std::pair<std::string, std::string>>& env_vars_pairs) {
+        const std::string& debug_port) {
+
+    auto env_allow = collect_env_allow(opts, std::string());
+    auto env_task = launch_env_task(opts, script_engine, env_allow);
+
+    // packages
+    auto packages = load_packages_list(modurl);
+
+    // env vars
+    auto env_vars = env_task.get();
+    auto env_vars_pairs = env_vars_to_pairs(env_vars);
+    if (!env_allow.empty()) {
+        env_vars = wilton::cli::env::filter(std::move(env_vars), env_allow);
+    }
 
     // startup call
     auto startup_call = sl::json::dumps({
@@ -542,7 +1010,10 @@ uint8_t run_new_project(const wilton::cli::cli_options& opts,
             std::move(env_vars), debug_port, startup_call);
 
     // init wilton
-    auto err_init = wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    auto err_init = [&config] {
+        wilton::cli::trace::phase ph("wiltoncall_init");
+        return wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    }();
     if (nullptr != err_init) {
         std::cerr << "ERROR: " << err_init << std::endl;
         wilton_free(err_init);
@@ -553,12 +1024,16 @@ uint8_t run_new_project(const wilton::cli::cli_options& opts,
     load_pre_engine_libs(opts);
 
     // load script engine
-    load_script_engine(script_engine, wilton_home, modurl, env_vars_pairs);
+    auto jvm_options = collect_jvm_options(opts, wilton_home, std::string(), env_vars_pairs);
+    load_script_engine(script_engine, modurl, env_vars_pairs, jvm_options);
 
     char* out = nullptr;
     int out_len = 0;
-    char* err_run = wiltoncall_runscript(script_engine.c_str(), static_cast<int>(script_engine.length()),
-            startup_call.c_str(), static_cast<int> (startup_call.length()), &out, &out_len);
+    char* err_run = [&] {
+        wilton::cli::trace::phase ph("wiltoncall_runscript");
+        return wiltoncall_runscript(script_engine.c_str(), static_cast<int>(script_engine.length()),
+                startup_call.c_str(), static_cast<int> (startup_call.length()), &out, &out_len);
+    }();
     auto outcleaner = sl::support::defer([out]() STATICLIB_NOEXCEPT {
         wilton_free(out);
     });
@@ -573,75 +1048,164 @@ uint8_t run_new_project(const wilton::cli::cli_options& opts,
 uint8_t run_startup_script(const wilton::cli::cli_options& opts,
         const std::string& script_engine, const std::string& wilton_exec,
         const std::string& wilton_home, const std::string& modurl,
-        std::vector<sl::json::value> packages, const std::string& debug_port,
-        std::vector<sl::json::field> env_vars,
-        const std::vector<std::pair<std::string, std::string>>& env_vars_pairs,
-        const std::vector<std::string>& appargs) {
-    // check startup script
-    auto startjs = 0 == opts.exec_one_liner ? opts.startup_script :
-            write_temp_one_liner(opts.exec_deps, opts.exec_code);
-    auto tmpcleaner = sl::support::defer([&opts, &startjs]() STATICLIB_NOEXCEPT {
-        if (0 != opts.exec_one_liner) {
-            std::remove(startjs.c_str());
-        }
-    });
-    auto startjs_path = sl::tinydir::path(startjs);
-    if (!startjs_path.exists()) {
-        std::cerr << "ERROR: specified script file not found: [" + startjs + "]" << std::endl;
+        const std::string& debug_port, const std::vector<std::string>& appargs) {
+    // check engine before anything is loaded
+    auto is_jvm = "rhino" == script_engine || "nashorn" == script_engine;
+    if (!opts.zygote.empty() && is_jvm) {
+        std::cerr << "ERROR: zygote mode cannot be used with JVM engines" << std::endl;
         return 1;
     }
-    if(!startjs_path.is_regular_file()) {
-        std::cerr << "ERROR: invalid script file specified: [" + startjs + "]" << std::endl;
+    if (!opts.jvm_server.empty() && !is_jvm) {
+        std::cerr << "ERROR: JVM server mode can only be used with 'rhino' and 'nashorn' engines," <<
+                " use 'zygote' option for other engines" << std::endl;
         return 1;
     }
 
+    // one-liners and stdin scripts are prepared in memory
+    auto inline_src = sl::support::optional<wilton::cli::inline_script::script>();
+    if (0 != opts.exec_one_liner) {
+        inline_src = sl::support::make_optional(wilton::cli::inline_script::render_one_liner(
+                opts.exec_deps, opts.exec_code));
+    } else if (wilton::cli::inline_script::stdin_script_name == opts.startup_script) {
+        inline_src = sl::support::make_optional(wilton::cli::inline_script::read_stdin());
+    }
+
+    // check startup script
+    auto inline_module = std::unique_ptr<wilton::cli::inline_script::temp_module>();
+    if (inline_src.has_value()) {
+        inline_module.reset(new wilton::cli::inline_script::temp_module(inline_src.value(), "wilton_inline"));
+    }
+    auto startjs = inline_src.has_value() ? inline_module->path() : opts.startup_script;
+    if (!inline_src.has_value()) {
+        auto startjs_path = sl::tinydir::path(startjs);
+        if (!startjs_path.exists()) {
+            std::cerr << "ERROR: specified script file not found: [" + startjs + "]" << std::endl;
+            return 1;
+        }
+        if(!startjs_path.is_regular_file()) {
+            std::cerr << "ERROR: invalid script file specified: [" + startjs + "]" << std::endl;
+            return 1;
+        }
+    }
+
+    // check startup cache
+    auto startjs_full = inline_src.has_value() ? startjs : sl::tinydir::full_path(startjs);
+    auto appdir = sl::utils::strip_filename(startjs_full);
+    auto cache = std::unique_ptr<wilton::cli::cache::startup_cache>();
+    auto cached = sl::support::optional<wilton::cli::cache::entry>();
+    if (!opts.startup_cache.empty() && !inline_src.has_value()) {
+        cache = create_startup_cache(opts, wilton_home, modurl, startjs_full, appdir);
+        cached = cache->lookup();
+    }
+
+    // independent phases, joined before 'wiltoncall_init'
+    auto serial = 0 != opts.startup_serial;
+    auto env_allow = collect_env_allow(opts, appdir);
+    auto env_task = launch_env_task(opts, script_engine, env_allow);
+    auto packages_task = cached.has_value() ?
+            wilton::cli::tasks::ready(std::move(cached.value().packages)) :
+            wilton::cli::tasks::launch<std::vector<sl::json::value>>(serial, [&modurl] {
+                return load_packages_list(modurl);
+            });
+    auto es_check_task = 0 != opts.load_only || 0 != opts.es_module ?
+            wilton::cli::tasks::ready(0 != opts.es_module) :
+            inline_src.has_value() ?
+            wilton::cli::tasks::ready(bool(inline_src.value().es_module)) :
+            wilton::cli::tasks::launch<bool>(serial, [&startjs_full] {
+                wilton::cli::trace::phase ph("check_es_module");
+                return check_es_module(startjs_full);
+            });
+    auto jvm_task = "rhino" != script_engine && "nashorn" != script_engine ?
+            wilton::cli::tasks::ready<wilton::cli::jvm::JNI_CreateJavaVM_type>(nullptr) :
+            wilton::cli::tasks::launch<wilton::cli::jvm::JNI_CreateJavaVM_type>(serial, preload_jvm);
+
     // get startup module
     auto startmod = std::string();
     auto startmod_dir = std::string();
     auto startmod_id = std::string();
-    auto startjs_full = sl::tinydir::full_path(startjs);
-    auto appdir = sl::utils::strip_filename(startjs_full);
+    auto startmod_name = cached.has_value() ? cached.value().startmod : opts.startup_module_name;
     std::tie(startmod, startmod_dir, startmod_id) = find_startup_module(
-            opts.startup_module_name, startjs_full, appdir);
+            startmod_name, startjs_full, appdir);
     if (startmod.empty()) {
         std::cerr << "ERROR: cannot determine startup module name, use '-s' to specify it" << std::endl;
         return 1;
     }
 
-    // prepare paths
-    auto paths = prepare_paths(wilton_home, opts.binary_modules_paths, startmod, startmod_dir);
+    // paths
+    auto paths = cached.has_value() ? std::move(cached.value().paths) :
+            prepare_paths(wilton_home, opts.binary_modules_paths, startmod, startmod_dir);
+
+    // join
+    auto packages = packages_task.get();
+    auto is_es_module = es_check_task.get();
+    auto env_vars = env_task.get();
+    auto jvm_preloaded = jvm_task.get();
+    // full environment is only needed to start JVM
+    auto env_vars_pairs = is_jvm ? env_vars_to_pairs(env_vars) :
+            std::vector<std::pair<std::string, std::string>>();
+    auto jvm_options = is_jvm ? collect_jvm_options(opts, wilton_home, appdir, env_vars_pairs) :
+            std::vector<std::string>();
+    if (!env_allow.empty()) {
+        env_vars = wilton::cli::env::filter(std::move(env_vars), env_allow);
+    }
 
-    // prepare args
-    auto args_json = std::vector<sl::json::value>();
-    for (auto& st : appargs) {
-        args_json.emplace_back(st);
+    // update startup cache
+    if (!cached.has_value() && nullptr != cache.get()) {
+        auto en = wilton::cli::cache::entry();
+        en.startmod = startmod;
+        en.paths = std::move(paths);
+        en.packages = std::move(packages);
+        cache->store(en);
+        paths = std::move(en.paths);
+        packages = std::move(en.packages);
     }
 
     // startup call
-    auto startup_call = std::string();
-    if (0 != opts.load_only) {
-        startup_call = sl::json::dumps({
-            {"module", startmod_id}
-        });
-    } else if (0 != opts.es_module || check_es_module(startjs_full)) {
-        startup_call = sl::json::dumps({
-            {"esmodule", "file://" + startjs_full},
-            {"args", std::move(args_json)}
-        });
-    } else {
-        startup_call = sl::json::dumps({
-            {"module", startmod_id},
-            {"func", "main"}, // optional, kept for compat
-            {"args", std::move(args_json)}
-        });
+    auto startup_call = make_startup_call(0 != opts.load_only, is_es_module,
+            startmod_id, startjs_full, appargs);
+    if (0 != opts.watch && is_es_module) {
+        std::cerr << "ERROR: 'watch' option cannot be used with ES modules" << std::endl;
+        return 1;
+    }
+    auto watched_binmods = 0 != opts.watch ? collect_watched_binmods(paths, startmod) :
+            std::vector<wilton::cli::watch::binmod>();
+    auto crypt_bundles = collect_crypt_bundles(opts, paths);
+
+    // fork workers, each of them continues startup from here
+    if (opts.workers > 0) {
+        auto pool = wilton::cli::supervisor::settings();
+        pool.workers = static_cast<uint32_t>(opts.workers);
+        for (auto& addr : sl::utils::split(opts.workers_listen, ',')) {
+            if (!addr.empty()) {
+                pool.listen.emplace_back(sl::utils::trim(addr));
+            }
+        }
+        auto pr = wilton::cli::supervisor::run_pool(pool);
+        if (!pr.is_worker) {
+            return pr.exit_code;
+        }
+        env_vars.emplace_back(wilton::cli::supervisor::worker_id_env_var,
+                sl::support::to_string(pr.worker_id));
+        env_vars.emplace_back(wilton::cli::supervisor::workers_count_env_var,
+                sl::support::to_string(pool.workers));
     }
+
+    // pin and lock before any wilton threads are started
+    auto placement = apply_placement(opts, appdir);
+
     // prepare wilton config
     auto config = create_wilton_config(opts, script_engine, wilton_exec, wilton_home,
             modurl, std::move(paths), std::move(packages), std::move(env_vars),
             debug_port, startup_call);
+    if (0 != opts.print_config) {
+        print_launcher_config(cache.get(), jvm_options, placement);
+    }
 
     // init wilton
-    auto err_init = wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    auto err_init = [&config] {
+        wilton::cli::trace::phase ph("wiltoncall_init");
+        return wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    }();
     if (nullptr != err_init) {
         std::cerr << "ERROR: " << err_init << std::endl;
         wilton_free(err_init);
@@ -650,40 +1214,301 @@ uint8_t run_startup_script(const wilton::cli::cli_options& opts,
 
     // load necessary libs
     load_pre_engine_libs(opts, appdir);
+    auto crypt_prefill = start_crypt_prefill(opts, crypt_bundles);
 
     // load script engine
-    load_script_engine(script_engine, wilton_home, modurl, env_vars_pairs);
+    auto jvm = load_script_engine(script_engine, modurl, env_vars_pairs, jvm_options, jvm_preloaded);
+
+    // check whether fork server mode is requested
+    if (!opts.zygote.empty()) {
+        crypt_prefill.reset();
+        return run_zygote(opts, script_engine, startmod, startmod_dir, startmod_id);
+    }
+
+    // check whether resident JVM mode is requested
+    if (!opts.jvm_server.empty()) {
+        return run_jvm_server(opts, script_engine, startmod, startmod_dir, startmod_id);
+    }
 
     // init signals/ctrl+c to allow their use from js
     if ("rhino" != script_engine && "nashorn" != script_engine) {
         init_signals();
     }
 
+    // metrics exporter
+    auto metrics = start_metrics(opts);
+
     // call script
-    char* out = nullptr;
-    int out_len = 0;
-    char* err_run = wiltoncall_runscript(script_engine.c_str(), static_cast<int>(script_engine.length()),
-            startup_call.c_str(), static_cast<int> (startup_call.length()), &out, &out_len);
-    auto outcleaner = sl::support::defer([out]() STATICLIB_NOEXCEPT {
-        wilton_free(out);
-    });
-    if (nullptr != err_run) {
-        std::cerr << "ERROR: " << err_run << std::endl;
-        wilton_free(err_run);
+    auto rescode = call_startup_script(script_engine, startup_call);
+
+    // re-run on changes until interrupted
+    if (0 != opts.watch) {
+        return run_watch(script_engine, startmod, startmod_dir, startmod_id,
+                watched_binmods, startup_call);
+    }
+
+    // CDS archive is written by JVM on shutdown
+    if (0 != opts.jvm_cds_dump) {
+        wilton::cli::jvm::destroy_vm(jvm);
+    }
+    return rescode;
+}
+
+uint8_t run_batch(const wilton::cli::cli_options& opts,
+        const std::string& script_engine, const std::string& wilton_exec,
+        const std::string& wilton_home, const std::string& modurl,
+        const std::string& debug_port) {
+    auto packages_task = wilton::cli::tasks::launch<std::vector<sl::json::value>>(
+            0 != opts.startup_serial, [&modurl] {
+                return load_packages_list(modurl);
+            });
+
+    // resolve all scripts before init, each startup module gets its own path
+    auto entries = wilton::cli::batch::read_entries(opts.batch);
+    if (entries.empty()) {
+        std::cerr << "ERROR: no scripts specified in batch: [" << opts.batch << "]" << std::endl;
         return 1;
-    } else if (out_len > 0) {
-        auto opt = parse_exit_code({out, out_len});
-        if (opt.has_value()) {
-            return opt.value();
-        } // pass through
+    }
+    auto modules = std::map<std::string, std::string>();
+    auto manifest = opts.binary_modules_paths.empty() ?
+            sl::support::optional<wilton::cli::libs::manifest>() :
+            wilton::cli::libs::load_manifest(wilton_home);
+    auto script_ids = std::vector<std::string>();
+    auto script_paths = std::vector<std::string>();
+    auto paths = std::vector<sl::json::field>();
+    for (auto& en : entries) {
+        auto path = sl::tinydir::path(en.script);
+        if (!(path.exists() && path.is_regular_file())) {
+            std::cerr << "ERROR: batch script file not found: [" << en.script << "]," <<
+                    " line: [" << en.line_number << "]" << std::endl;
+            return 1;
+        }
+        auto startjs_full = sl::tinydir::full_path(en.script);
+        auto appdir = sl::utils::strip_filename(startjs_full);
+        auto startmod = std::string();
+        auto startmod_dir = std::string();
+        auto startmod_id = std::string();
+        std::tie(startmod, startmod_dir, startmod_id) = find_startup_module(
+                opts.startup_module_name, startjs_full, appdir);
+        if (startmod.empty()) {
+            std::cerr << "ERROR: cannot determine startup module name for script: [" << en.script << "]" << std::endl;
+            return 1;
+        }
+        auto it = modules.find(startmod);
+        if (modules.end() == it) {
+            modules.insert(std::make_pair(startmod, startmod_dir));
+            if (paths.empty()) {
+                // vendor libs are added once
+                paths = prepare_paths(wilton_home, opts.binary_modules_paths, startmod, startmod_dir);
+            } else {
+                // binary modules are mapped for each startup module
+                paths.emplace_back(startmod, wilton::support::file_proto_prefix + startmod_dir);
+                append_binary_modules_paths(paths, opts.binary_modules_paths, startmod, manifest);
+            }
+        } else if (it->second != startmod_dir) {
+            std::cerr << "ERROR: startup module name conflict, name: [" << startmod << "]," <<
+                    " directories: [" << it->second << "], [" << startmod_dir << "]" << std::endl;
+            return 1;
+        }
+        script_ids.emplace_back(startmod_id);
+        script_paths.emplace_back(startjs_full);
+    }
+    auto first_appdir = sl::utils::strip_filename(script_paths.front());
+    auto env_allow = collect_env_allow(opts, first_appdir);
+    auto env_task = launch_env_task(opts, script_engine, env_allow);
+
+    // join
+    auto packages = packages_task.get();
+    auto env_vars = env_task.get();
+    auto env_vars_pairs = env_vars_to_pairs(env_vars);
+    auto jvm_options = "rhino" == script_engine || "nashorn" == script_engine ?
+            collect_jvm_options(opts, wilton_home, first_appdir, env_vars_pairs) :
+            std::vector<std::string>();
+    if (!env_allow.empty()) {
+        env_vars = wilton::cli::env::filter(std::move(env_vars), env_allow);
+    }
+
+    // prepare wilton config
+    auto crypt_bundles = collect_crypt_bundles(opts, paths);
+    auto placement = apply_placement(opts, first_appdir);
+    auto config = create_wilton_config(opts, script_engine, wilton_exec, wilton_home,
+            modurl, std::move(paths), std::move(packages), std::move(env_vars),
+            debug_port, opts.batch);
+    if (0 != opts.print_config) {
+        print_launcher_config(nullptr, jvm_options, placement);
+    }
+
+    // init wilton
+    auto err_init = [&config] {
+        wilton::cli::trace::phase ph("wiltoncall_init");
+        return wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    }();
+    if (nullptr != err_init) {
+        std::cerr << "ERROR: " << err_init << std::endl;
+        wilton_free(err_init);
+        return 1;
+    }
+
+    // load necessary libs, engine and signals once for all scripts
+    load_pre_engine_libs(opts, first_appdir);
+    auto crypt_prefill = start_crypt_prefill(opts, crypt_bundles);
+    load_script_engine(script_engine, modurl, env_vars_pairs, jvm_options);
+    if ("rhino" != script_engine && "nashorn" != script_engine) {
+        init_signals();
+    }
+    auto metrics = start_metrics(opts);
+
+    // run scripts one by one, failure of one script does not stop the batch
+    auto results = std::vector<wilton::cli::batch::result>();
+    auto batch_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto& en = entries.at(i);
+        auto re = wilton::cli::batch::result();
+        re.script = en.script;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            auto es_module = 0 != opts.es_module || check_es_module(script_paths.at(i));
+            auto startup_call = make_startup_call(0 != opts.load_only, es_module,
+                    script_ids.at(i), script_paths.at(i), en.args);
+            re.exit_code = call_startup_script(script_engine, startup_call);
+        } catch (const std::exception& e) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            re.exit_code = 1;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        re.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        std::cerr << wilton::cli::batch::result_json(re) << std::endl;
+        results.emplace_back(std::move(re));
+    }
+    auto total = std::chrono::steady_clock::now() - batch_start;
+    auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(total).count();
+    std::cerr << wilton::cli::batch::summary_json(results, total_us) << std::endl;
+    for (auto& re : results) {
+        if (0 != re.exit_code) {
+            return 1;
+        }
     }
     return 0;
 }
 
+uint8_t run_build_image(const wilton::cli::cli_options& opts,
+        const std::string& wilton_home, const std::string& modurl) {
+    auto startjs_path = sl::tinydir::path(opts.startup_script);
+    if (!(startjs_path.exists() && startjs_path.is_regular_file())) {
+        std::cerr << "ERROR: specified script file not found: [" + opts.startup_script + "]" << std::endl;
+        return 1;
+    }
+    auto startjs_full = sl::tinydir::full_path(opts.startup_script);
+    auto appdir = sl::utils::strip_filename(startjs_full);
+    if (0 != opts.es_module || check_es_module(startjs_full)) {
+        std::cerr << "ERROR: ES modules are not supported in application images" << std::endl;
+        return 1;
+    }
+    auto startmod = std::string();
+    auto startmod_dir = std::string();
+    auto startmod_id = std::string();
+    std::tie(startmod, startmod_dir, startmod_id) = find_startup_module(
+            opts.startup_module_name, startjs_full, appdir);
+    if (startmod.empty()) {
+        std::cerr << "ERROR: cannot determine startup module name, use '-s' to specify it" << std::endl;
+        return 1;
+    }
+
+    auto params = wilton::cli::image::build_params();
+    params.output = opts.output;
+    params.wilton_version = WILTON_VERSION_STR;
+    params.startmod = startmod;
+    params.startmod_id = startmod_id;
+    params.std_modurl = modurl;
+    params.paths = prepare_paths(wilton_home, opts.binary_modules_paths, startmod, startmod_dir);
+    params.packages = load_packages_list(modurl);
+    params.app_config = load_app_config(appdir);
+    params.includes.emplace_back(startmod_id);
+    if (params.app_config.has_value()) {
+        auto& json = params.app_config.value();
+        auto& incl = json["imageInclude"];
+        if (sl::json::type::nullt != incl.json_type()) {
+            for (auto& id : incl.as_array_or_throw("conf/config.json:imageInclude")) {
+                params.includes.emplace_back(id.as_string_nonempty_or_throw("conf/config.json:imageInclude"));
+            }
+        }
+    }
+    auto modules = wilton::cli::image::build(params);
+    auto modules_list = std::string();
+    for (auto& mod : modules) {
+        modules_list.append(modules_list.empty() ? "" : ", ").append(mod);
+    }
+    std::cout << "Application image written: [" << opts.output << "]," <<
+            " modules: [" << modules_list << "]" << std::endl;
+    return 0;
+}
+
+uint8_t run_image(const wilton::cli::cli_options& opts,
+        const std::string& script_engine, const std::string& wilton_exec,
+        const std::string& wilton_home, const std::string& debug_port,
+        const std::vector<std::string>& appargs) {
+    auto image_path = sl::tinydir::path(opts.startup_script);
+    if (!(image_path.exists() && image_path.is_regular_file())) {
+        std::cerr << "ERROR: specified application image not found: [" + opts.startup_script + "]" << std::endl;
+        return 1;
+    }
+    auto image_full = sl::tinydir::full_path(opts.startup_script);
+    // modules, packages and app config come from the image only
+    auto modurl = wilton::support::zip_proto_prefix + image_full;
+    auto appdir = image_full + "/";
+    auto mf = wilton::cli::image::read_manifest(image_full, WILTON_VERSION_STR);
+    if (mf.app_config.has_value()) {
+        register_app_config(appdir, mf.app_config.value());
+    }
+
+    auto env_allow = collect_env_allow(opts, appdir);
+    auto env_vars = launch_env_task(opts, script_engine, env_allow).get();
+    auto is_jvm = "rhino" == script_engine || "nashorn" == script_engine;
+    auto env_vars_pairs = is_jvm ? env_vars_to_pairs(env_vars) :
+            std::vector<std::pair<std::string, std::string>>();
+    auto jvm_options = is_jvm ? collect_jvm_options(opts, wilton_home, appdir, env_vars_pairs) :
+            std::vector<std::string>();
+    if (!env_allow.empty()) {
+        env_vars = wilton::cli::env::filter(std::move(env_vars), env_allow);
+    }
+
+    auto startup_call = make_startup_call(0 != opts.load_only, false,
+            mf.startmod_id, image_full, appargs);
+    auto placement = apply_placement(opts, appdir);
+    auto config = create_wilton_config(opts, script_engine, wilton_exec, wilton_home,
+            modurl, std::move(mf.paths), std::move(mf.packages), std::move(env_vars),
+            debug_port, startup_call);
+    if (0 != opts.print_config) {
+        print_launcher_config(nullptr, jvm_options, placement);
+    }
+
+    // init wilton
+    auto err_init = [&config] {
+        wilton::cli::trace::phase ph("wiltoncall_init");
+        return wiltoncall_init(config.c_str(), static_cast<int> (config.length()));
+    }();
+    if (nullptr != err_init) {
+        std::cerr << "ERROR: " << err_init << std::endl;
+        wilton_free(err_init);
+        return 1;
+    }
+
+    load_pre_engine_libs(opts, appdir);
+    load_script_engine(script_engine, modurl, env_vars_pairs, jvm_options);
+    if (!is_jvm) {
+        init_signals();
+    }
+    auto metrics = start_metrics(opts);
+    return call_startup_script(script_engine, startup_call);
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
     try {
+        // env changes made for allocator re-exec are not passed further
+        wilton::cli::allocator::restore_env_after_reexec();
+
         // parse launcher args
         int launcher_argc = find_launcher_args_end(argc, argv);
         wilton::cli::cli_options opts(launcher_argc, argv);
@@ -714,6 +1539,23 @@ int main(int argc, char** argv) {
             return 0;
         }
 
+        // startup trace
+        if (!opts.startup_trace.empty()) {
+            wilton::cli::trace::global_tracer().enable();
+        }
+        auto trace_writer = sl::support::defer([&opts]() STATICLIB_NOEXCEPT {
+            if (opts.startup_trace.empty()) {
+                return;
+            }
+            try {
+                auto& tracer = wilton::cli::trace::global_tracer();
+                tracer.print_summary(std::cerr);
+                tracer.write_json(opts.startup_trace);
+            } catch (const std::exception& e) {
+                std::cerr << "ERROR: cannot write startup trace, message: [" << e.what() << "]" << std::endl;
+            }
+        });
+
         // get wilton home
         auto wilton_exec = sl::tinydir::normalize_path(sl::utils::current_executable_path());
         auto wilton_home = sl::utils::strip_filename(sl::tinydir::normalize_path(sl::utils::strip_filename(wilton_exec)));
@@ -721,6 +1563,28 @@ int main(int argc, char** argv) {
         // set environment vars
         set_env_vars(opts.environment_vars);
 
+        // malloc tuning, must be done before any threads are started
+        auto alloc = prepare_allocator(opts, wilton_home, argv);
+        auto rss_reporter = sl::support::defer([&alloc]() STATICLIB_NOEXCEPT {
+            if (alloc.report_rss) {
+                wilton::cli::allocator::print_rss_report();
+            }
+        });
+
+        // warm up page cache for libraries that are going to be loaded,
+        // disk reads overlap with config building
+        wilton::cli::readahead::prefetcher prefetch(collect_readahead_files(opts, wilton_home));
+
+        // check whether this is a client for the fork server
+        if (!opts.zygote_connect.empty()) {
+            return wilton::cli::remote::run_client(opts.zygote_connect, opts.startup_script, appargs);
+        }
+
+        // check whether lib manifest generation is requested
+        if (0 != opts.index_libs) {
+            return run_index_libs(opts, wilton_home);
+        }
+
         // check whether GHC mode is requested
         if (0 != opts.ghc_init) {
             wilton::cli::ghc::init_and_run_main(wilton_home, opts.startup_script, appargs);
@@ -741,8 +1605,10 @@ int main(int argc, char** argv) {
             modurl.push_back('/');
         }
 
-        // packages
-        auto packages = load_packages_list(modurl);
+        // check whether application image build is requested
+        if (0 != opts.build_image) {
+            return run_build_image(opts, wilton_home, modurl);
+        }
 
         // get debug connection port, may be switched to int and defaulted to -1 eventually
         auto debug_port = !opts.debug_port.empty() ? opts.debug_port : std::string("");
@@ -753,23 +1619,20 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        // env vars
-        auto env_vars = collect_env_vars();
-        auto env_vars_pairs = std::vector<std::pair<std::string, std::string>>();
-        for (auto& fi : env_vars) {
-            env_vars_pairs.emplace_back(fi.name(), fi.as_string_or_throw(fi.name()));
-        }
-
         // check whether new-project requested
         uint8_t rescode = 0;
         if (!opts.new_project.empty()) {
             rescode = run_new_project(opts, script_engine, wilton_exec, wilton_home,
-                    modurl, std::move(packages), debug_port, std::move(env_vars),
-                    env_vars_pairs);
+                    modurl, debug_port);
+        } else if (!opts.batch.empty()) {
+            rescode = run_batch(opts, script_engine, wilton_exec, wilton_home,
+                    modurl, debug_port);
+        } else if (wilton::cli::image::is_image(opts.startup_script)) {
+            rescode = run_image(opts, script_engine, wilton_exec, wilton_home,
+                    debug_port, appargs);
         } else {
             rescode = run_startup_script(opts, script_engine, wilton_exec, wilton_home,
-                    modurl, std::move(packages), debug_port, std::move(env_vars),
-                    env_vars_pairs, appargs);
+                    modurl, debug_port, appargs);
         }
         return rescode;
 
@@ -26,6 +26,7 @@
 #define WILTON_CLI_OPTIONS_HPP
 
 #include <algorithm>
+#include <cstdlib>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,10 @@ namespace wilton {
 namespace cli {
 
 class cli_options {
+    // values returned by 'poptGetNextOpt' for repeatable options
+    enum repeatable {
+        jvm_opt_val = 1001
+    };
     std::vector<struct poptOption> table;
     char* modules_dir_or_zip_ptr = nullptr;
     char* startup_module_name_ptr = nullptr;
@@ -44,6 +49,20 @@ class cli_options {
     char* new_project_ptr = nullptr;
     char* environment_vars_ptr = nullptr;
     char* crypt_call_ptr = nullptr;
+    char* startup_trace_ptr = nullptr;
+    char* startup_cache_ptr = nullptr;
+    char* zygote_ptr = nullptr;
+    char* jvm_server_ptr = nullptr;
+    char* batch_ptr = nullptr;
+    char* env_allow_ptr = nullptr;
+    char* output_ptr = nullptr;
+    char* workers_listen_ptr = nullptr;
+    char* cpu_affinity_ptr = nullptr;
+    char* sched_policy_ptr = nullptr;
+    char* thp_ptr = nullptr;
+    char* metrics_ptr = nullptr;
+    char* allocator_ptr = nullptr;
+    char* zygote_connect_ptr = nullptr;
 
 public:
     poptContext ctx = nullptr;
@@ -60,6 +79,30 @@ public:
     std::string environment_vars;
     std::string crypt_call_lib;
     std::string crypt_call_name;
+    std::string startup_trace;
+    std::string startup_cache;
+    std::string zygote;
+    std::string jvm_server;
+    std::string batch;
+    std::string env_allow;
+    std::string output;
+    int workers = 0;
+    std::string workers_listen;
+    std::string cpu_affinity;
+    int numa_node = -1;
+    int mlockall = 0;
+    std::string sched_policy;
+    int sched_priority = 0;
+    int malloc_arenas = -1;
+    int malloc_trim_threshold = -1;
+    int malloc_mmap_threshold = -1;
+    std::string thp;
+    std::string allocator;
+    int report_rss = 0;
+    std::string metrics;
+    int metrics_interval = 10;
+    std::string zygote_connect;
+    std::vector<std::string> jvm_options;
     int exec_one_liner = 0;
     int es_module = 0;
     int print_config = 0;
@@ -67,6 +110,13 @@ public:
     int help = 0;
     int trace_enable = 0;
     int ghc_init = 0;
+    int index_libs = 0;
+    int build_image = 0;
+    int startup_serial = 0;
+    int crypt_cache = 0;
+    int crypt_threads = 0;
+    int jvm_cds_dump = 0;
+    int watch = 0;
     int version = 0;
 
     std::string startup_script;
@@ -89,6 +139,37 @@ public:
         { "new-project", 'n', POPT_ARG_STRING, std::addressof(new_project_ptr), static_cast<int> ('n'), "Create a new 'wilton application' project", nullptr},
         { "environment-vars", 'r', POPT_ARG_STRING, std::addressof(environment_vars_ptr), static_cast<int> ('r'), "Additional environment variables with ':' separator", nullptr},
         { "crypt-call", 'c', POPT_ARG_STRING, std::addressof(crypt_call_ptr), static_cast<int> ('c'), "Description of the native call in 'libname:callname' format to use for loading encrypted .wlib modules", nullptr},
+        { "crypt-cache", 0, POPT_ARG_NONE, std::addressof(crypt_cache), 0, "Decrypt all entries of '-b' modules in parallel at startup and keep them in locked memory, requires 'crypt-call'; each module load still copies its plaintext to a loader buffer that is not zeroed when freed", nullptr},
+        { "crypt-threads", 0, POPT_ARG_INT, std::addressof(crypt_threads), 0, "Number of threads to use for 'crypt-cache' decryption, default: number of CPUs", nullptr},
+        { "env-allow", 0, POPT_ARG_STRING, std::addressof(env_allow_ptr), 0, "Environment variables name patterns list with ':' separator to include into config, other variables are not passed to the app", nullptr},
+        { "startup-trace", 0, POPT_ARG_STRING, std::addressof(startup_trace_ptr), 0, "Write startup phases timings to the specified file in trace-event JSON format", nullptr},
+        { "startup-cache", 0, POPT_ARG_STRING, std::addressof(startup_cache_ptr), 0, "Directory to cache resolved modules paths and packages between launches", nullptr},
+        { "startup-serial", 0, POPT_ARG_NONE, std::addressof(startup_serial), 0, "Run independent startup phases sequentially instead of in parallel", nullptr},
+        { "batch", 0, POPT_ARG_STRING, std::addressof(batch_ptr), 0, "Run scripts listed in the specified file ('-' for stdin, one JSON object per line) in one process", nullptr},
+        { "watch", 0, POPT_ARG_NONE, std::addressof(watch), 0, "Keep runtime initialized after the script is finished, re-run it when its modules are changed (Linux only)", nullptr},
+        { "zygote", 0, POPT_ARG_STRING, std::addressof(zygote_ptr), 0, "Initialize runtime once and fork it for each launch request received on the specified unix socket, jobs run with client environment, config lists environment variables of the zygote itself", nullptr},
+        { "jvm-server", 0, POPT_ARG_STRING, std::addressof(jvm_server_ptr), 0, "Keep 'rhino' or 'nashorn' engine JVM running and execute launch requests received on the specified unix socket, use 'zygote-connect' to send them; jobs run one at a time, clients connecting while a job is running are rejected, jobs share JS globals, loaded modules and process-wide stdio, env and cwd, a client that disconnects is detached and its job keeps running", nullptr},
+        { "zygote-connect", 0, POPT_ARG_STRING, std::addressof(zygote_connect_ptr), 0, "Run specified script in the zygote listening on the specified unix socket", nullptr},
+        { "jvm-opt", 0, POPT_ARG_STRING, nullptr, static_cast<int> (jvm_opt_val), "Option to pass to JVM for 'rhino' and 'nashorn' engines, can be specified multiple times", nullptr},
+        { "jvm-cds-dump", 0, POPT_ARG_NONE, std::addressof(jvm_cds_dump), 0, "Record classes loaded by JVM into class-data-sharing archive under 'wilton_home/cds' (JDK 13+)", nullptr},
+        { "workers", 0, POPT_ARG_INT, std::addressof(workers), 0, "Run specified number of worker processes, forked after startup preparation, crashed workers are restarted", nullptr},
+        { "workers-listen", 0, POPT_ARG_STRING, std::addressof(workers_listen_ptr), 0, "Addresses list with ',' separator ('host:port') to listen on in supervisor, sockets are passed to workers as fds starting from 3 with LISTEN_FDS and LISTEN_PID set, wilton modules do not use them, the script must pick them up itself", nullptr},
+        { "metrics", 0, POPT_ARG_STRING, std::addressof(metrics_ptr), 0, "Export process metrics in Prometheus format, 'unix:path/to/socket' to serve them or a file to append them to (Linux only)", nullptr},
+        { "metrics-interval", 0, POPT_ARG_INT, std::addressof(metrics_interval), 0, "Interval in seconds for appending metrics to a file, default: 10", nullptr},
+        { "malloc-arenas", 0, POPT_ARG_INT, std::addressof(malloc_arenas), 0, "Max number of glibc malloc arenas (Linux only)", nullptr},
+        { "malloc-trim-threshold", 0, POPT_ARG_INT, std::addressof(malloc_trim_threshold), 0, "glibc malloc trim threshold in bytes (Linux only)", nullptr},
+        { "malloc-mmap-threshold", 0, POPT_ARG_INT, std::addressof(malloc_mmap_threshold), 0, "glibc malloc mmap threshold in bytes (Linux only)", nullptr},
+        { "thp", 0, POPT_ARG_STRING, std::addressof(thp_ptr), 0, "Transparent huge pages for malloc heaps: 'always' or 'never' (Linux only)", nullptr},
+        { "allocator", 0, POPT_ARG_STRING, std::addressof(allocator_ptr), 0, "Allocator library from 'WILTON_HOME/bin' to preload, for example: 'libjemalloc.so.2' (Linux only)", nullptr},
+        { "report-rss", 0, POPT_ARG_NONE, std::addressof(report_rss), 0, "Print current and peak RSS on exit", nullptr},
+        { "cpu-affinity", 0, POPT_ARG_STRING, std::addressof(cpu_affinity_ptr), 0, "CPUs list to run on, for example: '0-3,8' (Linux only)", nullptr},
+        { "numa-node", 0, POPT_ARG_INT, std::addressof(numa_node), 0, "NUMA node to bind memory allocations to, also binds to node CPUs if 'cpu-affinity' is not specified (Linux only)", nullptr},
+        { "mlockall", 0, POPT_ARG_NONE, std::addressof(mlockall), 0, "Lock all current and future process memory in RAM (Linux only)", nullptr},
+        { "sched-policy", 0, POPT_ARG_STRING, std::addressof(sched_policy_ptr), 0, "Scheduling policy: 'other', 'batch', 'idle', 'fifo' or 'rr' (Linux only)", nullptr},
+        { "sched-priority", 0, POPT_ARG_INT, std::addressof(sched_priority), 0, "Scheduling priority for 'fifo' and 'rr' policies", nullptr},
+        { "build-image", 0, POPT_ARG_NONE, std::addressof(build_image), 0, "Pack specified script with its dependencies and frozen config into a single application image (requires '-o')", nullptr},
+        { "output", 'o', POPT_ARG_STRING, std::addressof(output_ptr), static_cast<int> ('o'), "Output file path for '--build-image', must end with '.wimg'", nullptr},
+        { "index-libs", 0, POPT_ARG_NONE, std::addressof(index_libs), 0, "Write manifest of 'lib' directory (and binary modules, if specified) to speed up startup", nullptr},
         { "version", 'v', POPT_ARG_NONE, std::addressof(version), static_cast<int> ('v'), "Show version number", nullptr},
         { "help", 'h', POPT_ARG_NONE, std::addressof(help), static_cast<int> ('h'), "Show this help message", nullptr},
         { nullptr, 0, 0, nullptr, 0, nullptr, nullptr}
@@ -104,7 +185,15 @@ public:
 
         { // parse options
             int val;
-            while ((val = poptGetNextOpt(ctx)) >= 0);
+            while ((val = poptGetNextOpt(ctx)) >= 0) {
+                if (jvm_opt_val == val) {
+                    char* arg = poptGetOptArg(ctx);
+                    if (nullptr != arg) {
+                        jvm_options.emplace_back(arg);
+                        std::free(arg);
+                    }
+                }
+            }
             if (val < -1) {
                 parse_error.append(poptStrerror(val));
                 parse_error.append(": ");
@@ -122,14 +211,14 @@ public:
 
         if (0 == help && 0 == version) {
             // check script specified
-            if (0 == exec_one_liner && nullptr == new_project_ptr &&
+            if (0 == exec_one_liner && nullptr == new_project_ptr && 0 == index_libs && nullptr == batch_ptr &&
                     (1 != args.size() || args.at(0).empty())) {
                 parse_error.append("invalid arguments, startup script not specified");
                 return;
             }
 
             // set options and fix slashes
-            if (nullptr == new_project_ptr) {
+            if (nullptr == new_project_ptr && 0 == index_libs && nullptr == batch_ptr) {
                 if (0 == exec_one_liner) {
                     startup_script = args.at(0);
                     std::replace(startup_script.begin(), startup_script.end(), '\\', '/');
@@ -152,6 +241,61 @@ public:
             debug_port = (nullptr != debug_port_ptr) ? std::string(debug_port_ptr) : "";
             new_project = (nullptr != new_project_ptr) ? std::string(new_project_ptr) : "";
             environment_vars = (nullptr != environment_vars_ptr) ? std::string(environment_vars_ptr) : "";
+            startup_trace = (nullptr != startup_trace_ptr) ? std::string(startup_trace_ptr) : "";
+            startup_cache = (nullptr != startup_cache_ptr) ? std::string(startup_cache_ptr) : "";
+            zygote = (nullptr != zygote_ptr) ? std::string(zygote_ptr) : "";
+            jvm_server = (nullptr != jvm_server_ptr) ? std::string(jvm_server_ptr) : "";
+            if (!jvm_server.empty() && (!zygote.empty() || workers > 0 || 0 != watch ||
+                    0 != exec_one_liner || 0 != load_only || "-" == startup_script)) {
+                parse_error.append("'jvm-server' option cannot be used with 'zygote', 'workers', 'watch'," +
+                        std::string(" one-liners, stdin script or 'load-only' option"));
+                return;
+            }
+            batch = (nullptr != batch_ptr) ? std::string(batch_ptr) : "";
+            env_allow = (nullptr != env_allow_ptr) ? std::string(env_allow_ptr) : "";
+            output = (nullptr != output_ptr) ? std::string(output_ptr) : "";
+            workers_listen = (nullptr != workers_listen_ptr) ? std::string(workers_listen_ptr) : "";
+            cpu_affinity = (nullptr != cpu_affinity_ptr) ? std::string(cpu_affinity_ptr) : "";
+            sched_policy = (nullptr != sched_policy_ptr) ? std::string(sched_policy_ptr) : "";
+            thp = (nullptr != thp_ptr) ? std::string(thp_ptr) : "";
+            metrics = (nullptr != metrics_ptr) ? std::string(metrics_ptr) : "";
+            if (!metrics.empty() && metrics_interval < 1) {
+                parse_error.append("invalid 'metrics-interval' value specified");
+                return;
+            }
+            allocator = (nullptr != allocator_ptr) ? std::string(allocator_ptr) : "";
+            if (malloc_arenas < -1 || malloc_trim_threshold < -1 || malloc_mmap_threshold < -1) {
+                parse_error.append("invalid 'malloc-*' value specified");
+                return;
+            }
+            if (workers < 0 || (!workers_listen.empty() && 0 == workers)) {
+                parse_error.append("invalid 'workers' value specified");
+                return;
+            }
+            if (0 != watch && (!zygote.empty() || workers > 0 || 0 != exec_one_liner ||
+                    "-" == startup_script || 0 != es_module)) {
+                parse_error.append("'watch' option cannot be used with 'zygote', 'workers', one-liners, stdin script or ES modules");
+                return;
+            }
+            if (workers > 0 && (!zygote.empty() || 0 != exec_one_liner || "-" == startup_script || 0 != load_only)) {
+                parse_error.append("'workers' option cannot be used with 'zygote', one-liners, stdin script or 'load-only' option");
+                return;
+            }
+            if (numa_node < -1 || (0 != sched_priority && sched_policy.empty())) {
+                parse_error.append("invalid 'numa-node' or 'sched-priority' value specified");
+                return;
+            }
+            std::replace(output.begin(), output.end(), '\\', '/');
+            if (0 != build_image && (0 != exec_one_liner || !sl::utils::ends_with(output, ".wimg"))) {
+                parse_error.append("'build-image' option requires a script file and '-o path/to/app.wimg'");
+                return;
+            }
+            zygote_connect = (nullptr != zygote_connect_ptr) ? std::string(zygote_connect_ptr) : "";
+            if (!zygote.empty() && (0 != exec_one_liner || 0 != load_only || "-" == startup_script)) {
+                parse_error.append("'zygote' option cannot be used with one-liners, stdin script or 'load-only' option");
+                return;
+            }
+            std::replace(startup_cache.begin(), startup_cache.end(), '\\', '/');
 
             if (nullptr != crypt_call_ptr) {
                 auto crypt_call = std::string(crypt_call_ptr);
@@ -165,11 +309,15 @@ public:
                 crypt_call_lib = std::move(parts.at(0));
                 crypt_call_name = std::move(parts.at(1));
             }
+            if ((0 != crypt_cache && crypt_call_name.empty()) || crypt_threads < 0) {
+                parse_error.append("'crypt-cache' option requires 'crypt-call', 'crypt-threads' must not be negative");
+                return;
+            }
         }
     }
 
     const std::string usage() {
-        std::string msg = "USAGE: wilton path/to/script.js"
+        std::string msg = "USAGE: wilton path/to/script.js|-"
                 " [OPTION...]"
                 " [-- <app arguments>]";
         return msg;
@@ -0,0 +1,372 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   crypt_cache.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:51 AM
+ */
+
+#ifndef WILTON_CLI_CRYPT_CACHE_HPP
+#define WILTON_CLI_CRYPT_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+#include <sys/mman.h>
+#endif // !STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/wiltoncall.h"
+
+#include "wilton/support/exception.hpp"
+
+#include "app_image.hpp"
+#include "file_stamp.hpp"
+#include "startup_trace.hpp"
+#include "zip_index.hpp"
+
+namespace wilton {
+namespace cli {
+namespace crypt {
+
+// registered instead of the 'crypt-call' one and passed to the loader as 'cryptCall'
+const std::string cached_call_name = "wilton_cli_crypt_cached";
+
+// Decrypted data is kept in anonymous mapping that is locked in RAM
+// and excluded from core dumps, it is zeroed before unmapping.
+// Locking is best effort, it is limited by RLIMIT_MEMLOCK.
+class locked_buffer {
+    char* ptr = nullptr;
+    size_t len = 0;
+
+public:
+    locked_buffer() { }
+
+    locked_buffer(const char* data, size_t length) {
+        if (0 == length) {
+            return;
+        }
+#ifndef STATICLIB_WINDOWS
+        auto mem = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == mem) throw support::exception(TRACEMSG(
+                "'mmap' error, size: [" + sl::support::to_string(length) + "]"));
+        ptr = static_cast<char*>(mem);
+        len = length;
+#ifdef MADV_DONTDUMP
+        ::madvise(ptr, len, MADV_DONTDUMP);
+#endif // MADV_DONTDUMP
+        if (0 != ::mlock(ptr, len)) {
+            warn_not_locked();
+        }
+#else // STATICLIB_WINDOWS
+        ptr = new char[length];
+        len = length;
+#endif // !STATICLIB_WINDOWS
+        std::memcpy(ptr, data, len);
+    }
+
+    locked_buffer(const locked_buffer&) = delete;
+
+    locked_buffer& operator=(const locked_buffer&) = delete;
+
+    locked_buffer(locked_buffer&& other) :
+    ptr(other.ptr),
+    len(other.len) {
+        other.ptr = nullptr;
+        other.len = 0;
+    }
+
+    locked_buffer& operator=(locked_buffer&& other) {
+        std::swap(ptr, other.ptr);
+        std::swap(len, other.len);
+        return *this;
+    }
+
+    ~locked_buffer() STATICLIB_NOEXCEPT {
+        if (nullptr == ptr) {
+            return;
+        }
+        volatile char* vptr = ptr;
+        for (size_t i = 0; i < len; i++) {
+            vptr[i] = 0;
+        }
+#ifndef STATICLIB_WINDOWS
+        ::munlock(ptr, len);
+        ::munmap(ptr, len);
+#else // STATICLIB_WINDOWS
+        delete[] ptr;
+#endif // !STATICLIB_WINDOWS
+    }
+
+    const char* data() const {
+        return ptr;
+    }
+
+    size_t size() const {
+        return len;
+    }
+
+private:
+    static void warn_not_locked() {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true)) {
+            std::cerr << "WARNING: cannot lock decrypted modules in memory," <<
+                    " check 'ulimit -l'" << std::endl;
+        }
+    }
+};
+
+namespace { // anonymous
+
+char* copy_to_wilton(const char* data, size_t len) {
+    auto res = wilton_alloc(static_cast<int>(len + 1));
+    if (len > 0) {
+        std::memcpy(res, data, len);
+    }
+    res[len] = '\0';
+    return res;
+}
+
+locked_buffer call_decrypt(const std::string& call_name, const char* encrypted, size_t encrypted_len) {
+    char* out = nullptr;
+    int out_len = 0;
+    auto err = wiltoncall(call_name.c_str(), static_cast<int>(call_name.length()),
+            encrypted, static_cast<int>(encrypted_len),
+            std::addressof(out), std::addressof(out_len));
+    if (nullptr != err) {
+        support::throw_wilton_error(err, TRACEMSG(err));
+    }
+    if (nullptr == out) {
+        return locked_buffer();
+    }
+    auto deferred = sl::support::defer([out, out_len]() STATICLIB_NOEXCEPT {
+        std::memset(out, '\0', static_cast<size_t>(out_len));
+        wilton_free(out);
+    });
+    return locked_buffer(out, static_cast<size_t>(out_len));
+}
+
+// Inputs are keyed by length and two differently seeded 64-bit hashes
+// instead of the full encrypted data, so cache does not keep a second
+// copy of every bundle entry. Inputs come from the app own bundles,
+// hash is not expected to withstand crafted collisions.
+std::string input_key(const char* data, size_t len) {
+    auto res = std::string();
+    res.resize(sizeof(uint64_t) * 3);
+    auto fields = std::array<uint64_t, 3>{{
+        static_cast<uint64_t>(len),
+        hash_fnv1a(data, len),
+        hash_fnv1a(data, len, 0x84222325cbf29ce4ULL)
+    }};
+    std::memcpy(std::addressof(res.front()), fields.data(), res.length());
+    return res;
+}
+
+} // namespace
+
+// result of the 'crypt-call' for one encrypted input, errors are
+// cached too, the call is expected to be deterministic
+struct slot {
+    bool ready = false;
+    std::string error;
+    locked_buffer plain;
+};
+
+// Memoizes 'crypt-call' results by encrypted input key, each input is decrypted
+// once, concurrent requests for the same input wait for the first one.
+class cache {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::unordered_map<std::string, std::shared_ptr<slot>> slots;
+    std::string call_name;
+
+public:
+    void set_call_name(const std::string& name) {
+        call_name = name;
+    }
+
+    // called by prefill workers, no-op if input is already known
+    void prefill(const std::string& encrypted) {
+        auto key = input_key(encrypted.data(), encrypted.length());
+        auto sl = std::shared_ptr<slot>();
+        {
+            std::lock_guard<std::mutex> guard{mtx};
+            if (slots.end() != slots.find(key)) {
+                return;
+            }
+            sl = std::make_shared<slot>();
+            slots.insert(std::make_pair(std::move(key), sl));
+        }
+        fill(sl, encrypted.data(), encrypted.length());
+    }
+
+    std::shared_ptr<slot> get(const char* encrypted, size_t encrypted_len) {
+        auto key = input_key(encrypted, encrypted_len);
+        auto sl = std::shared_ptr<slot>();
+        {
+            std::unique_lock<std::mutex> lock{mtx};
+            auto it = slots.find(key);
+            if (slots.end() != it) {
+                auto found = it->second;
+                cv.wait(lock, [&found] {
+                    return found->ready;
+                });
+                return found;
+            }
+            sl = std::make_shared<slot>();
+            slots.insert(std::make_pair(std::move(key), sl));
+        }
+        fill(sl, encrypted, encrypted_len);
+        return sl;
+    }
+
+private:
+    void fill(std::shared_ptr<slot>& sl, const char* encrypted, size_t encrypted_len) {
+        auto plain = locked_buffer();
+        auto error = std::string();
+        try {
+            plain = call_decrypt(call_name, encrypted, encrypted_len);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        {
+            std::lock_guard<std::mutex> guard{mtx};
+            sl->plain = std::move(plain);
+            sl->error = std::move(error);
+            sl->ready = true;
+        }
+        cv.notify_all();
+    }
+};
+
+cache& global_cache() {
+    static cache instance;
+    return instance;
+}
+
+namespace { // anonymous
+
+char* cached_call(void* ctx, const char* data_in, int data_in_len, char** data_out, int* data_out_len) {
+    try {
+        auto& ca = *static_cast<cache*>(ctx);
+        auto sl = ca.get(data_in, static_cast<size_t>(data_in_len));
+        if (!sl->error.empty()) {
+            return copy_to_wilton(sl->error.data(), sl->error.length());
+        }
+        // loader gets an ordinary wilton buffer, it is not zeroed when freed
+        *data_out = copy_to_wilton(sl->plain.data(), sl->plain.size());
+        *data_out_len = static_cast<int>(sl->plain.size());
+        return nullptr;
+    } catch (const std::exception& e) {
+        auto msg = TRACEMSG(std::string(e.what()) + "\nDecrypted modules cache error");
+        return copy_to_wilton(msg.data(), msg.length());
+    }
+}
+
+} // namespace
+
+// must be called after 'crypt-call' module is loaded
+void register_cached_call(const std::string& crypt_call_name) {
+    auto& ca = global_cache();
+    ca.set_call_name(crypt_call_name);
+    auto err = wiltoncall_register(cached_call_name.c_str(), static_cast<int>(cached_call_name.length()),
+            static_cast<void*>(std::addressof(ca)), cached_call);
+    if (nullptr != err) {
+        support::throw_wilton_error(err, TRACEMSG(err));
+    }
+}
+
+// Decrypts all entries of the specified bundles into global cache on
+// a pool of threads, module loads that come before their entry is
+// ready decrypt it themselves or wait for the worker that does it.
+// Threads are joined in destructor.
+class prefiller {
+    std::vector<std::pair<std::string, std::string>> jobs;
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+
+public:
+    prefiller() { }
+
+    prefiller(const std::vector<std::string>& bundles, uint32_t threads) {
+        for (auto& zp : bundles) {
+            auto idx = zip::open_index(zp);
+            for (auto& en : idx->get_entries()) {
+                if (!sl::utils::ends_with(en, "/")) {
+                    jobs.emplace_back(zp, en);
+                }
+            }
+        }
+        if (0 == threads) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        auto count = std::min(static_cast<size_t>(threads), jobs.size());
+        for (size_t i = 0; i < count; i++) {
+            workers.emplace_back([this] {
+                run_jobs();
+            });
+        }
+    }
+
+    prefiller(const prefiller&) = delete;
+
+    prefiller& operator=(const prefiller&) = delete;
+
+    ~prefiller() STATICLIB_NOEXCEPT {
+        for (auto& th : workers) {
+            th.join();
+        }
+    }
+
+private:
+    void run_jobs() {
+        auto& ca = global_cache();
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            auto& jo = jobs[i];
+            trace::phase ph("crypt::decrypt", jo.first + ":" + jo.second);
+            try {
+                ca.prefill(image::read_zip_entry(jo.first, jo.second));
+            } catch (const std::exception&) {
+                // entry will be read and decrypted by loader
+            }
+        }
+    }
+};
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_CRYPT_CACHE_HPP */
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   env_filter.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:31 AM
+ */
+
+#ifndef WILTON_CLI_ENV_FILTER_HPP
+#define WILTON_CLI_ENV_FILTER_HPP
+
+#include <string>
+#include <vector>
+
+#include "staticlib/json.hpp"
+#include "staticlib/utils.hpp"
+
+namespace wilton {
+namespace cli {
+namespace env {
+
+// 'PATH:JAVA_*:APP_?' -> ['PATH', 'JAVA_*', 'APP_?']
+std::vector<std::string> parse_patterns(const std::string& list) {
+    auto res = std::vector<std::string>();
+    for (auto& pa : sl::utils::split(list, ':')) {
+        auto trimmed = sl::utils::trim(pa);
+        if (!trimmed.empty()) {
+            res.emplace_back(std::move(trimmed));
+        }
+    }
+    return res;
+}
+
+// '*' matches any sequence, '?' matches single char
+bool glob_match(const std::string& pattern, const std::string& name) {
+    size_t pi = 0;
+    size_t ni = 0;
+    size_t star = std::string::npos;
+    size_t star_ni = 0;
+    while (ni < name.length()) {
+        if (pi < pattern.length() && ('?' == pattern[pi] || pattern[pi] == name[ni])) {
+            pi += 1;
+            ni += 1;
+        } else if (pi < pattern.length() && '*' == pattern[pi]) {
+            star = pi;
+            star_ni = ni;
+            pi += 1;
+        } else if (std::string::npos != star) {
+            pi = star + 1;
+            star_ni += 1;
+            ni = star_ni;
+        } else {
+            return false;
+        }
+    }
+    while (pi < pattern.length() && '*' == pattern[pi]) {
+        pi += 1;
+    }
+    return pi == pattern.length();
+}
+
+bool is_allowed(const std::vector<std::string>& patterns, const std::string& name) {
+    for (auto& pa : patterns) {
+        if (glob_match(pa, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<sl::json::field> filter(std::vector<sl::json::field> vars,
+        const std::vector<std::string>& patterns) {
+    auto res = std::vector<sl::json::field>();
+    for (auto& fi : vars) {
+        if (is_allowed(patterns, fi.name())) {
+            res.emplace_back(std::move(fi));
+        }
+    }
+    return res;
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_ENV_FILTER_HPP */
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   file_stamp.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:21 AM
+ */
+
+#ifndef WILTON_CLI_FILE_STAMP_HPP
+#define WILTON_CLI_FILE_STAMP_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <string>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_WINDOWS
+#include <direct.h>
+#include "staticlib/support/windows.hpp"
+#else // !STATICLIB_WINDOWS
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+namespace wilton {
+namespace cli {
+
+struct file_stamp {
+    bool exists = false;
+    bool directory = false;
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+
+    std::string to_string() const {
+        if (!exists) {
+            return "-";
+        }
+        return std::string(directory ? "d" : "f") + ":" + sl::support::to_string(size) +
+                ":" + sl::support::to_string(mtime_ns);
+    }
+};
+
+// single 'stat' call, does not throw on missing files
+file_stamp read_file_stamp(const std::string& path) {
+    auto res = file_stamp();
+#ifdef STATICLIB_WINDOWS
+    auto wpath = sl::utils::widen(path);
+    struct _stat64 st;
+    if (0 != ::_wstat64(wpath.c_str(), std::addressof(st))) {
+        return res;
+    }
+    res.directory = 0 != (st.st_mode & _S_IFDIR);
+    res.mtime_ns = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else // !STATICLIB_WINDOWS
+    struct stat st;
+    if (0 != ::stat(path.c_str(), std::addressof(st))) {
+        return res;
+    }
+    res.directory = S_ISDIR(st.st_mode);
+#if defined(STATICLIB_MAC)
+    res.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else // !STATICLIB_MAC
+    res.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif // STATICLIB_MAC
+#endif // STATICLIB_WINDOWS
+    res.exists = true;
+    res.size = static_cast<uint64_t>(st.st_size);
+    return res;
+}
+
+std::string current_directory() {
+#ifdef STATICLIB_WINDOWS
+    auto wbuf = std::wstring();
+    wbuf.resize(MAX_PATH + 1);
+    auto ptr = ::_wgetcwd(std::addressof(wbuf.front()), static_cast<int>(wbuf.length()));
+    if (nullptr == ptr) {
+        return std::string();
+    }
+    wbuf.resize(std::wcslen(ptr));
+    return sl::utils::narrow(wbuf);
+#else // !STATICLIB_WINDOWS
+    auto buf = std::string();
+    buf.resize(4096);
+    auto ptr = ::getcwd(std::addressof(buf.front()), buf.length());
+    if (nullptr == ptr) {
+        return std::string();
+    }
+    buf.resize(std::strlen(ptr));
+    return buf;
+#endif // STATICLIB_WINDOWS
+}
+
+// FNV-1a, used for cache file names and content checks, not for security
+uint64_t hash_fnv1a(const char* data, size_t len, uint64_t seed = 14695981039346656037ULL) {
+    uint64_t res = seed;
+    for (size_t i = 0; i < len; i++) {
+        res ^= static_cast<unsigned char>(data[i]);
+        res *= 1099511628211ULL;
+    }
+    return res;
+}
+
+std::string hash_fnv1a_hex(const std::string& str) {
+    auto hash = hash_fnv1a(str.data(), str.length());
+    auto res = std::string();
+    res.resize(16);
+    static const char* hex = "0123456789abcdef";
+    for (size_t i = 0; i < 16; i++) {
+        res[15 - i] = hex[hash & 0xf];
+        hash >>= 4;
+    }
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* WILTON_CLI_FILE_STAMP_HPP */
@@ -0,0 +1,283 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   inline_script.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:29 AM
+ */
+
+#ifndef WILTON_CLI_INLINE_SCRIPT_HPP
+#define WILTON_CLI_INLINE_SCRIPT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_WINDOWS
+#include "staticlib/support/windows.hpp"
+#else // !STATICLIB_WINDOWS
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#ifdef STATICLIB_LINUX
+#include <sys/syscall.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace cli {
+namespace inline_script {
+
+// Script source that exists only in launcher memory: '-e' one-liner or
+// a script read from stdin with 'wilton -'. Loader resolves modules by URL
+// only, so the source is exposed to it through 'temp_module' and everything
+// the launcher needs is taken from memory.
+struct script {
+    std::string source;
+    bool es_module = false;
+};
+
+const std::string stdin_script_name = "-";
+
+script render_one_liner(const std::string& deps, const std::string& code) {
+    auto deps_line = std::string();
+    auto args_line = std::string();
+    if (deps.length() > 0) {
+        auto parts = sl::utils::split(deps, ':');
+        for (size_t i = 0; i < parts.size(); i++) {
+            auto dep = parts.at(i);
+            if (dep.length() > 0) {
+                deps_line.append("\"").append(dep).append("\"");
+                if (i < parts.size() - 1) {
+                    deps_line.append(", ");
+                }
+                auto dep_parts = sl::utils::split(dep, '/');
+                if (dep_parts.size() > 0) {
+                    auto dep_name = dep_parts.back();
+                    args_line.append(dep_name);
+                    if (i < parts.size() - 1) {
+                        args_line.append(", ");
+                    }
+                }
+            }
+        }
+    }
+
+    auto res = script();
+    res.source.append("\n")
+            .append("define([").append(deps_line).append("], function(").append(args_line).append(") {\n")
+            .append("    \"use strict\";\n")
+            .append("    return {\n")
+            .append("        main: function() {\n")
+            .append("            var RESULT = ").append(code).append(";\n")
+            .append("            print(RESULT);\n")
+            .append("        }\n")
+            .append("    };\n")
+            .append("});");
+    res.es_module = false; // AMD template
+    return res;
+}
+
+// same heuristic as for script files, applied to the in-memory source
+bool detect_es_module(const std::string& source) {
+    std::istringstream st(source.substr(0, 1024));
+    auto line = std::string();
+    for (size_t i = 0; i < 32 && std::getline(st, line); i++) {
+        auto trimmed = sl::utils::trim(line);
+        if (sl::utils::starts_with(trimmed, "define")) {
+            return false;
+        }
+        if (sl::utils::starts_with(trimmed, "import")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+script read_stdin() {
+    auto res = script();
+    res.source = std::string(std::istreambuf_iterator<char>(std::cin),
+            std::istreambuf_iterator<char>());
+    if (std::cin.bad()) {
+        throw support::exception(TRACEMSG("Error reading script from stdin"));
+    }
+    res.es_module = detect_es_module(res.source);
+    return res;
+}
+
+// tmpfs is preferred so the source never hits the disk
+std::string temp_dir() {
+#ifdef STATICLIB_WINDOWS
+    auto wbuf = std::wstring();
+    wbuf.resize(MAX_PATH + 1);
+    auto len = ::GetTempPathW(static_cast<DWORD>(wbuf.length()), std::addressof(wbuf.front()));
+    // note: unlikely failure to obtain temp dir may be ignored for one-liner purposes
+    wbuf.resize(len);
+    auto dir = sl::utils::narrow(wbuf);
+    std::replace(dir.begin(), dir.end(), '\\', '/');
+    while (sl::utils::ends_with(dir, "/")) {
+        dir.pop_back();
+    }
+    return dir;
+#else // !STATICLIB_WINDOWS
+#ifdef STATICLIB_LINUX
+    auto shm = sl::tinydir::path("/dev/shm");
+    if (shm.exists() && shm.is_directory() && 0 == ::access("/dev/shm", W_OK)) {
+        return "/dev/shm";
+    }
+#endif // STATICLIB_LINUX
+    auto tmpdir = std::getenv("TMPDIR");
+    if (nullptr != tmpdir && '\0' != tmpdir[0]) {
+        auto dir = std::string(tmpdir);
+        while (dir.length() > 1 && sl::utils::ends_with(dir, "/")) {
+            dir.pop_back();
+        }
+        return dir;
+    }
+    return "/tmp";
+#endif // STATICLIB_WINDOWS
+}
+
+// Module file for the loader in a new private directory (mode 0700,
+// created with 'mkdtemp'), so other users cannot replace it or plant
+// 'conf/config.json' next to it. On Linux the source is kept in an anonymous
+// memory file and the directory only contains a symlink to it, so the source
+// is not written to any filesystem. Everything is removed in destructor.
+class temp_module {
+    std::string dir;
+    std::string file;
+    int memfd = -1;
+
+public:
+    temp_module(const script& sc, const std::string& name) {
+        dir = create_private_dir();
+        file = dir + name + ".js";
+        try {
+            if (!link_memfd(sc)) {
+                auto sink = sl::tinydir::file_sink(file);
+                sl::io::write_all(sink, {sc.source.data(), sc.source.length()});
+            }
+        } catch (...) {
+            cleanup();
+            throw;
+        }
+    }
+
+    temp_module(const temp_module&) = delete;
+
+    temp_module& operator=(const temp_module&) = delete;
+
+    ~temp_module() STATICLIB_NOEXCEPT {
+        cleanup();
+    }
+
+    // full path, directory is used as startup module dir
+    const std::string& path() const {
+        return file;
+    }
+
+private:
+    static std::string create_private_dir() {
+#ifndef STATICLIB_WINDOWS
+        auto tmpl = temp_dir() + "/wilton_XXXXXX";
+        auto buf = std::vector<char>(tmpl.begin(), tmpl.end());
+        buf.push_back('\0');
+        if (nullptr == ::mkdtemp(buf.data())) throw support::exception(TRACEMSG(
+                "Cannot create temp directory, path: [" + tmpl + "]," +
+                " error: [" + std::string(std::strerror(errno)) + "]"));
+        return std::string(buf.data()) + "/";
+#else // STATICLIB_WINDOWS
+        // temp dir is per-user on windows
+        auto rsg = sl::utils::random_string_generator();
+        auto res = temp_dir() + "/wilton_" + rsg.generate(8);
+        sl::tinydir::create_directory(res);
+        return res + "/";
+#endif // !STATICLIB_WINDOWS
+    }
+
+#if defined(STATICLIB_LINUX) && defined(SYS_memfd_create)
+    // false if memfd or '/proc' are not available, file is written then
+    bool link_memfd(const script& sc) {
+        // MFD_CLOEXEC
+        memfd = static_cast<int>(::syscall(SYS_memfd_create, "wilton_inline", 1u));
+        if (-1 == memfd) {
+            return false;
+        }
+        size_t written = 0;
+        while (written < sc.source.length()) {
+            auto res = ::write(memfd, sc.source.data() + written, sc.source.length() - written);
+            if (res < 0) {
+                if (EINTR == errno) continue;
+                return close_memfd();
+            }
+            written += static_cast<size_t>(res);
+        }
+        // fd is inherited by forked workers, '/proc/self' stays valid there
+        auto target = "/proc/self/fd/" + sl::support::to_string(memfd);
+        if (0 != ::access(target.c_str(), R_OK) || 0 != ::symlink(target.c_str(), file.c_str())) {
+            return close_memfd();
+        }
+        return true;
+    }
+
+    bool close_memfd() {
+        ::close(memfd);
+        memfd = -1;
+        return false;
+    }
+#else // !STATICLIB_LINUX
+    bool link_memfd(const script&) {
+        return false;
+    }
+#endif // STATICLIB_LINUX
+
+    void cleanup() STATICLIB_NOEXCEPT {
+        std::remove(file.c_str());
+        try {
+            sl::tinydir::path(dir).remove();
+        } catch (const std::exception&) {
+            // leftover empty dir
+        }
+#ifndef STATICLIB_WINDOWS
+        if (-1 != memfd) {
+            ::close(memfd);
+            memfd = -1;
+        }
+#endif // !STATICLIB_WINDOWS
+    }
+};
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_INLINE_SCRIPT_HPP */
@@ -46,6 +46,9 @@
 
 #include "wilton/support/exception.hpp"
 
+#include "file_stamp.hpp"
+#include "startup_trace.hpp"
+
 namespace wilton {
 namespace cli {
 namespace jvm {
@@ -54,14 +57,19 @@ typedef jint(*JNI_CreateJavaVM_type)(JavaVM** p_vm, JNIEnv** p_env, void* vm_arg
 
 #ifdef STATICLIB_WINDOWS
 const std::string cl_separ = ";";
+const std::string libjvm_name = "jvm.dll";
+#elif defined(STATICLIB_MAC)
+const std::string cl_separ = ":";
+const std::string libjvm_name = "libjvm.dylib";
 #else // !STATICLIB_WINDOWS
 const std::string cl_separ = ":";
+const std::string libjvm_name = "libjvm.so";
 #endif // STATICLIB_WINDOWS
 
 #ifdef STATICLIB_WINDOWS
 
 JNI_CreateJavaVM_type load_jvm_platform(const std::string& libdir) {
-    auto libpath = libdir + "jvm.dll";
+    auto libpath = libdir + libjvm_name;
     auto wpath = sl::utils::widen(libpath);
     auto lib = ::LoadLibraryW(wpath.c_str());
     if (nullptr == lib) {
@@ -85,11 +93,7 @@ JNI_CreateJavaVM_type load_jvm_platform(const std::string& libdir) {
         auto res = ::dlerror();
         return nullptr != res ? std::string(res) : "";
     };
-#ifdef STATICLIB_MAC
-    auto libpath = libdir + "libjvm.dylib";
-#else // !STATICLIB_MAC
-    auto libpath = libdir + "libjvm.so";
-#endif // STATICLIB_MAC
+    auto libpath = libdir + libjvm_name;
     auto lib = ::dlopen(libpath.c_str(), RTLD_LAZY);
     if (nullptr == lib) throw support::exception(TRACEMSG(
             "Error loading shared library on path: [" + libpath + "]," +
@@ -103,7 +107,8 @@ JNI_CreateJavaVM_type load_jvm_platform(const std::string& libdir) {
 
 #endif // STATICLIB_WINDOWS
 
-JNI_CreateJavaVM_type load_jvm(const std::vector<std::pair<std::string, std::string>>& env_vars) {
+// directory of JVM shared library under JAVA_HOME
+std::string find_libjvm_dir(const std::vector<std::pair<std::string, std::string>>& env_vars) {
     auto java_home = std::string();
     for (auto& pa : env_vars) {
         if ("JAVA_HOME" == pa.first) {
@@ -138,6 +143,12 @@ JNI_CreateJavaVM_type load_jvm(const std::vector<std::pair<std::string, std::str
     } else throw wilton::support::exception(TRACEMSG(
             "Cannot find JVM shared library, base dir: [" + basedir + "]"));
 #endif // !STATICLIB_WINDOWS
+    return libdir;
+}
+
+JNI_CreateJavaVM_type load_jvm(const std::vector<std::pair<std::string, std::string>>& env_vars) {
+    trace::phase ph("jvm::load_jvm");
+    auto libdir = find_libjvm_dir(env_vars);
     // platform load
     return load_jvm_platform(libdir);
 }
@@ -182,9 +193,10 @@ std::string describe_java_exception(JNIEnv* env, jthrowable exc) {
     return std::string(cstr, cstr_len);
 }
 
-void load_engine(const std::string& script_engine, const std::string& exedir,
-        const std::string& modurl, const std::vector<std::pair<std::string, std::string>>& env_vars) {
-    // start jvm
+// user options go last, so they can override defaults
+std::vector<std::string> vm_options(const std::string& exedir,
+        const std::vector<std::pair<std::string, std::string>>& env_vars,
+        const std::vector<std::string>& user_options) {
     auto opt_libpath = std::string("-Djava.library.path=") + exedir;
     auto opt_classpath = std::string("-Djava.class.path=") + exedir + "wilton_rhino.jar";
     for (auto& pa : env_vars) {
@@ -193,20 +205,82 @@ void load_engine(const std::string& script_engine, const std::string& exedir,
             break;
         }
     }
+    auto res = std::vector<std::string>();
+    res.emplace_back(std::move(opt_libpath));
+    res.emplace_back(std::move(opt_classpath));
+    for (auto& opt : user_options) {
+        res.emplace_back(opt);
+    }
+    return res;
+}
+
+// Application class-data-sharing archive, its name depends on the
+// classpath and JDK, so archive created for other setup is not picked up.
+// Changed jars with the same paths are detected by JVM itself.
+std::string cds_archive_path(const std::string& wilton_home, const std::vector<std::string>& base_options,
+        const std::vector<std::pair<std::string, std::string>>& env_vars) {
+    auto key = std::string();
+    for (auto& opt : base_options) {
+        key.append(opt);
+        key.push_back('\n');
+    }
+    for (auto& pa : env_vars) {
+        if ("JAVA_HOME" == pa.first) {
+            key.append(pa.second);
+            break;
+        }
+    }
+    return wilton_home + "cds/wilton_rhino_" + hash_fnv1a_hex(key) + ".jsa";
+}
+
+std::vector<std::string> cds_options(const std::string& archive, bool dump) {
+    auto res = std::vector<std::string>();
+    if (dump) {
+        auto dir = sl::utils::strip_filename(archive);
+        if (!sl::tinydir::path(dir).exists()) {
+            sl::tinydir::create_directory(dir);
+        }
+        // requires JDK 13+, archive is written on JVM exit
+        res.emplace_back("-XX:ArchiveClassesAtExit=" + archive);
+    } else if (read_file_stamp(archive).exists) {
+        // 'auto' falls back to normal class loading if archive cannot be mapped
+        res.emplace_back("-XX:SharedArchiveFile=" + archive);
+        res.emplace_back("-Xshare:auto");
+    }
+    return res;
+}
+
+void destroy_vm(JavaVM* jvm) {
+    if (nullptr != jvm) {
+        trace::phase ph("jvm::destroy_vm");
+        jvm->DestroyJavaVM();
+    }
+}
+
+JavaVM* load_engine(const std::string& script_engine, const std::vector<std::string>& options,
+        const std::string& modurl, const std::vector<std::pair<std::string, std::string>>& env_vars,
+        JNI_CreateJavaVM_type JNI_CreateJavaVM_preloaded = nullptr) {
+    // start jvm
     JavaVM* jvm = nullptr;
     JNIEnv* env = nullptr;
     JavaVMInitArgs vm_args;
     std::memset(std::addressof(vm_args), '\0', sizeof(vm_args));
-    std::array<JavaVMOption, 2> vm_opts;
-    std::memset(std::addressof(vm_opts), '\0', sizeof(vm_opts));
-    vm_opts[0].optionString = opt_libpath.c_str();
-    vm_opts[1].optionString = opt_classpath.c_str();
+    auto vm_opts = std::vector<JavaVMOption>();
+    vm_opts.resize(options.size());
+    std::memset(vm_opts.data(), '\0', vm_opts.size() * sizeof(JavaVMOption));
+    for (size_t i = 0; i < options.size(); i++) {
+        vm_opts[i].optionString = options[i].c_str();
+    }
     vm_args.version = JNI_VERSION_1_6;
     vm_args.nOptions = static_cast<jint>(vm_opts.size());
     vm_args.options = vm_opts.data();
     vm_args.ignoreUnrecognized = 0;
-    auto JNI_CreateJavaVM_fun = load_jvm(env_vars);
-    auto err = JNI_CreateJavaVM_fun(std::addressof(jvm), std::addressof(env), std::addressof(vm_args));
+    auto JNI_CreateJavaVM_fun = nullptr != JNI_CreateJavaVM_preloaded ?
+            JNI_CreateJavaVM_preloaded : load_jvm(env_vars);
+    auto err = [&] {
+        trace::phase ph("JNI_CreateJavaVM");
+        return JNI_CreateJavaVM_fun(std::addressof(jvm), std::addressof(env), std::addressof(vm_args));
+    }();
     if (JNI_OK  != err) throw wilton::support::exception(TRACEMSG(
             "JVM startup error, code: [" + sl::support::to_string(err) + "]"));
 
@@ -221,6 +295,7 @@ void load_engine(const std::string& script_engine, const std::string& exedir,
     });
 
     // init rhino
+    trace::phase ph_init("jvm::initialize_engine", script_engine);
     auto class_name = "rhino" == script_engine ? 
         std::string("wilton/support/rhino/WiltonRhinoInitializer") :
         std::string("wilton/support/nashorn/WiltonNashornInitializer");
@@ -247,6 +322,7 @@ void load_engine(const std::string& script_engine, const std::string& exedir,
     //    https://stackoverflow.com/a/10991021/314015
     //    jvm->DestroyJavaVM();
     //};
+    return jvm;
 }
 
 } // namespace
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   jvm_server.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:45 AM
+ */
+
+#ifndef WILTON_CLI_JVM_SERVER_HPP
+#define WILTON_CLI_JVM_SERVER_HPP
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+#include <poll.h>
+#include <unistd.h>
+#endif // !STATICLIB_WINDOWS
+
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "remote_launch.hpp"
+
+#if defined(STATICLIB_MAC)
+extern char** environ;
+#endif // STATICLIB_MAC
+
+namespace wilton {
+namespace cli {
+namespace jvm_server {
+
+#ifndef STATICLIB_WINDOWS
+
+namespace { // anonymous
+
+std::vector<std::pair<std::string, std::string>> environment_snapshot() {
+    auto res = std::vector<std::pair<std::string, std::string>>();
+    for (char** el = environ; nullptr != el && nullptr != *el; el++) {
+        auto var = std::string(*el);
+        auto pos = var.find('=');
+        if (std::string::npos != pos && pos > 0) {
+            res.emplace_back(var.substr(0, pos), var.substr(pos + 1));
+        }
+    }
+    return res;
+}
+
+void reply(int fd, const sl::json::value& json) {
+    try {
+        remote::write_line(fd, sl::json::dumps(json));
+    } catch (const std::exception&) {
+        // client gone
+    }
+}
+
+bool has_stop_signal(remote::signal_pipe& sigs) {
+    auto res = false;
+    for (int sig : sigs.drain()) {
+        res = res || SIGINT == sig || SIGTERM == sig;
+    }
+    return res;
+}
+
+// client sends nothing after the request, readable socket means it is gone
+bool client_disconnected(int cfd) {
+    std::array<char, 64> buf;
+    auto len = ::read(cfd, buf.data(), buf.size());
+    return 0 == len || (len < 0 && EINTR != errno && EAGAIN != errno);
+}
+
+// only one job runs at a time, other clients get an error instead of
+// waiting silently behind it
+void reject_busy(int lfd) {
+    int cfd = ::accept(lfd, nullptr, nullptr);
+    if (-1 == cfd) {
+        return;
+    }
+    auto cfd_closer = sl::support::defer([cfd]() STATICLIB_NOEXCEPT {
+        ::close(cfd);
+    });
+    if (!remote::peer_is_same_user(cfd)) {
+        reply(cfd, {{"error", "client user does not match JVM server user"}});
+        return;
+    }
+    try {
+        // request is read so that client does not fail on send
+        auto req = remote::receive_request(cfd);
+        remote::close_stdio_fds(req);
+    } catch (const std::exception&) {
+        // reply anyway
+    }
+    reply(cfd, {{"error", "JVM server is busy, jobs are run one at a time"}});
+}
+
+struct job_wait_result {
+    bool client_attached = true;
+    bool stop_requested = false;
+};
+
+// Waits for the job thread. Client that disconnects is detached, job keeps
+// running and its result is discarded. After the first stop signal server
+// exits when the job is finished, second signal terminates it immediately,
+// running JVM thread cannot be cancelled.
+job_wait_result wait_for_job(remote::signal_pipe& sigs, int lfd, int cfd, int done_fd,
+        int server_stderr, const std::string& socket_path) {
+    auto res = job_wait_result();
+    for (;;) {
+        std::array<struct pollfd, 4> pfds;
+        pfds[0].fd = done_fd;
+        pfds[1].fd = sigs.read_fd();
+        pfds[2].fd = res.stop_requested ? -1 : lfd;
+        pfds[3].fd = res.client_attached ? cfd : -1;
+        for (auto& pfd : pfds) {
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+        }
+        if (::poll(pfds.data(), pfds.size(), -1) <= 0) {
+            continue;
+        }
+        if (0 != pfds[0].revents) {
+            return res;
+        }
+        if (0 != (pfds[1].revents & POLLIN) && has_stop_signal(sigs)) {
+            if (res.stop_requested) {
+                ::dup2(server_stderr, STDERR_FILENO);
+                std::cerr << "ERROR: JVM server job interrupted, job cannot be cancelled, server exits" << std::endl;
+                ::unlink(socket_path.c_str());
+                ::_exit(1);
+            }
+            res.stop_requested = true;
+        }
+        if (0 != (pfds[2].revents & POLLIN)) {
+            reject_busy(lfd);
+        }
+        if (0 != pfds[3].revents && client_disconnected(cfd)) {
+            res.client_attached = false;
+        }
+    }
+}
+
+} // namespace
+
+// Serves launch requests with the same protocol as zygote, so clients
+// use '--zygote-connect'. JVM cannot be forked, jobs run in this process
+// one at a time, each on a new thread attached to the same warmed up JVM,
+// global JS state and loaded requireJs modules are shared between jobs.
+// Client stdio, env and cwd are switched process-wide for the duration
+// of the job and restored after it, JVM threads started by the job and
+// still running after it are not isolated from the next job. Clients
+// connecting while a job is running are rejected. Job pid is not sent to
+// the client, client disconnect (for example on Ctrl+C) detaches it from
+// the job, running JVM thread cannot be cancelled.
+void serve(const std::string& socket_path, std::function<uint8_t(const remote::request&)> job_fun) {
+    int lfd = remote::listen_socket(socket_path);
+    auto deferred = sl::support::defer([lfd, &socket_path]() STATICLIB_NOEXCEPT {
+        ::close(lfd);
+        ::unlink(socket_path.c_str());
+    });
+    remote::signal_pipe sigs({SIGINT, SIGTERM});
+    std::signal(SIGPIPE, SIG_IGN);
+    auto server_env = environment_snapshot();
+    auto server_cwd = current_directory();
+    auto server_stdio = std::array<int, 3>{{::dup(STDIN_FILENO), ::dup(STDOUT_FILENO), ::dup(STDERR_FILENO)}};
+    auto stdio_closer = sl::support::defer([&server_stdio]() STATICLIB_NOEXCEPT {
+        for (int fd : server_stdio) {
+            ::close(fd);
+        }
+    });
+    std::cerr << "JVM server is listening on socket: [" << socket_path << "]" << std::endl;
+
+    for (;;) {
+        std::array<struct pollfd, 2> pfds;
+        pfds[0].fd = sigs.read_fd();
+        pfds[1].fd = lfd;
+        for (auto& pfd : pfds) {
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+        }
+        auto polled = ::poll(pfds.data(), pfds.size(), -1);
+        if (polled <= 0) {
+            continue;
+        }
+        if (0 != (pfds[0].revents & POLLIN) && has_stop_signal(sigs)) {
+            break;
+        }
+        if (0 == (pfds[1].revents & POLLIN)) {
+            continue;
+        }
+        int cfd = ::accept(lfd, nullptr, nullptr);
+        if (-1 == cfd) {
+            continue;
+        }
+        auto cfd_closer = sl::support::defer([cfd]() STATICLIB_NOEXCEPT {
+            ::close(cfd);
+        });
+        if (!remote::peer_is_same_user(cfd)) {
+            reply(cfd, {{"error", "client user does not match JVM server user"}});
+            continue;
+        }
+        auto req = remote::request();
+        try {
+            req = remote::receive_request(cfd);
+        } catch (const std::exception& e) {
+            reply(cfd, {{"error", std::string(e.what())}});
+            continue;
+        }
+        std::array<int, 2> done = {{-1, -1}};
+        if (0 != ::pipe(done.data())) {
+            remote::close_stdio_fds(req);
+            reply(cfd, {{"error", "pipe error: [" + remote::errno_str() + "]"}});
+            continue;
+        }
+        auto done_closer = sl::support::defer([&done]() STATICLIB_NOEXCEPT {
+            ::close(done[0]);
+            ::close(done[1]);
+        });
+
+        // switch to client
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        ::dup2(req.stdio_fds[0], STDIN_FILENO);
+        ::dup2(req.stdio_fds[1], STDOUT_FILENO);
+        ::dup2(req.stdio_fds[2], STDERR_FILENO);
+        remote::close_stdio_fds(req);
+
+        uint8_t code = 1;
+        auto worker = std::thread([&req, &job_fun, &code, &done] {
+            try {
+                remote::apply_request_env(req);
+                code = job_fun(req);
+            } catch (const std::exception& e) {
+                std::cerr << "ERROR: " << e.what() << std::endl;
+            }
+            char ch = 1;
+            while (-1 == ::write(done[1], std::addressof(ch), 1) && EINTR == errno) { }
+        });
+        auto waited = wait_for_job(sigs, lfd, cfd, done[0], server_stdio[2], socket_path);
+        worker.join();
+
+        // switch back
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        ::dup2(server_stdio[0], STDIN_FILENO);
+        ::dup2(server_stdio[1], STDOUT_FILENO);
+        ::dup2(server_stdio[2], STDERR_FILENO);
+        auto restore = remote::request();
+        restore.env = server_env;
+        restore.cwd = server_cwd;
+        remote::apply_request_env(restore);
+        if (waited.client_attached) {
+            reply(cfd, {{"exitCode", static_cast<int64_t>(code)}});
+        }
+        if (waited.stop_requested) {
+            break;
+        }
+    }
+}
+
+#else // STATICLIB_WINDOWS
+
+void serve(const std::string&, std::function<uint8_t(const remote::request&)>) {
+    throw support::exception(TRACEMSG("JVM server mode is not supported on this platform"));
+}
+
+#endif // !STATICLIB_WINDOWS
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_JVM_SERVER_HPP */
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lib_manifest.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:22 AM
+ */
+
+#ifndef WILTON_CLI_LIB_MANIFEST_HPP
+#define WILTON_CLI_LIB_MANIFEST_HPP
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+#include "wilton/support/misc.hpp"
+
+#include "file_stamp.hpp"
+#include "startup_trace.hpp"
+
+namespace wilton {
+namespace cli {
+namespace libs {
+
+const std::string manifest_file_name = "lib-manifest.json";
+
+struct manifest {
+    std::vector<sl::json::field> modules;
+    std::vector<sl::json::field> binary_modules;
+    std::string work_dir;
+
+    // Empty result means the path is not indexed or the indexed file was
+    // moved or changed since indexing, it must be checked on FS.
+    // Indexed file is checked with a single 'stat' call.
+    std::string find_binary_module(const std::string& path, const std::string& cwd) const {
+        if (cwd != work_dir) {
+            return std::string();
+        }
+        for (auto& fi : binary_modules) {
+            if (path == fi.name()) {
+                if (sl::json::type::object != fi.val().json_type()) {
+                    return std::string();
+                }
+                auto& fullpath = fi.val()["path"].as_string();
+                auto& stamp = fi.val()["stamp"].as_string();
+                auto st = read_file_stamp(fullpath);
+                if (fullpath.empty() || !st.exists || st.directory || stamp != st.to_string()) {
+                    return std::string();
+                }
+                return fullpath;
+            }
+        }
+        return std::string();
+    }
+};
+
+std::vector<sl::json::field> scan_lib_dir(const std::string& libdir_path) {
+    trace::phase ph("libs::scan_lib_dir");
+    auto res = std::vector<sl::json::field>();
+    auto libdir = sl::tinydir::path(libdir_path);
+    if (libdir.exists()) {
+        for (sl::tinydir::path& libpath : sl::tinydir::list_directory(libdir.filepath())) {
+            if (libpath.is_directory()) {
+                auto& modname = libpath.filename();
+                res.emplace_back(modname, support::file_proto_prefix + libpath.filepath());
+            } else if (sl::utils::ends_with(libpath.filename(), ".js")) {
+                const auto& modname = libpath.filename().substr(0, libpath.filename().length() - 3);
+                const auto& dirpath = sl::utils::strip_filename(libpath.filepath());
+                res.emplace_back(modname, support::file_proto_prefix + dirpath + modname);
+            } else if (sl::utils::ends_with(libpath.filename(), ".wlib")) {
+                const auto& modname = libpath.filename().substr(0, libpath.filename().length() - 5);
+                res.emplace_back(modname, support::zip_proto_prefix + libpath.filepath());
+            }
+        }
+    }
+    return res;
+}
+
+// returns empty optional when manifest is missing or stale
+sl::support::optional<manifest> load_manifest(const std::string& wilton_home) {
+    trace::phase ph("libs::load_manifest");
+    auto path = wilton_home + manifest_file_name;
+    auto res = manifest();
+    try {
+        if (!read_file_stamp(path).exists) {
+            return sl::support::optional<manifest>();
+        }
+        auto src = sl::tinydir::file_source(path);
+        auto json = sl::json::load(src);
+        auto stamp = std::string();
+        for (auto& fi : json.as_object_or_throw(path)) {
+            if ("libDirStamp" == fi.name()) {
+                stamp = fi.val().as_string_or_throw(path + ":libDirStamp");
+            } else if ("modules" == fi.name()) {
+                res.modules = std::move(fi.val().as_object_or_throw(path + ":modules"));
+            } else if ("binaryModules" == fi.name()) {
+                res.binary_modules = std::move(fi.val().as_object_or_throw(path + ":binaryModules"));
+            } else if ("workDir" == fi.name()) {
+                res.work_dir = fi.val().as_string_or_throw(path + ":workDir");
+            }
+        }
+        if (stamp != read_file_stamp(wilton_home + "lib").to_string()) {
+            return sl::support::optional<manifest>();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "WARNING: ignoring invalid lib manifest: [" << path << "]," <<
+                " message: [" << e.what() << "]" << std::endl;
+        return sl::support::optional<manifest>();
+    }
+    return sl::support::make_optional(std::move(res));
+}
+
+std::string write_manifest(const std::string& wilton_home,
+        const std::vector<std::pair<std::string, std::string>>& binary_modules) {
+    auto libdir = wilton_home + "lib";
+    // stamp is taken before the scan, concurrent changes make manifest stale
+    auto stamp = read_file_stamp(libdir).to_string();
+    auto modules = scan_lib_dir(libdir);
+    auto binmods = std::vector<sl::json::field>();
+    for (auto& pa : binary_modules) {
+        binmods.emplace_back(pa.first, sl::json::value({
+            {"path", pa.second},
+            {"stamp", read_file_stamp(pa.second).to_string()}
+        }));
+    }
+    auto json = sl::json::dumps({
+        {"libDirStamp", stamp},
+        {"modules", std::move(modules)},
+        {"binaryModules", std::move(binmods)},
+        {"workDir", current_directory()}
+    });
+    auto path = wilton_home + manifest_file_name;
+    auto tmp = path + ".tmp";
+    {
+        auto sink = sl::tinydir::path(tmp).open_write();
+        sl::io::write_all(sink, {json.data(), json.length()});
+    }
+#ifdef STATICLIB_WINDOWS
+    std::remove(path.c_str());
+#endif // STATICLIB_WINDOWS
+    if (0 != std::rename(tmp.c_str(), path.c_str())) {
+        std::remove(tmp.c_str());
+        throw support::exception(TRACEMSG("Error writing lib manifest, path: [" + path + "]"));
+    }
+    return path;
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_LIB_MANIFEST_HPP */
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   metrics.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:41 AM
+ */
+
+#ifndef WILTON_CLI_METRICS_HPP
+#define WILTON_CLI_METRICS_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_LINUX
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "remote_launch.hpp"
+
+namespace wilton {
+namespace cli {
+namespace metrics {
+
+// '--metrics unix:/path/to/metrics.sock' serves the metrics on each
+// connection, any other value is a file the metrics are appended to
+const std::string unix_socket_prefix = "unix:";
+
+#ifdef STATICLIB_LINUX
+
+namespace { // anonymous
+
+struct sample {
+    uint64_t rss_bytes = 0;
+    double cpu_user_seconds = 0;
+    double cpu_system_seconds = 0;
+    uint64_t threads = 0;
+    uint64_t open_fds = 0;
+    uint64_t ctx_voluntary = 0;
+    uint64_t ctx_involuntary = 0;
+    uint64_t faults_minor = 0;
+    uint64_t faults_major = 0;
+};
+
+double to_seconds(const struct timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1000000;
+}
+
+uint64_t parse_kb(const std::string& val) {
+    // '12345 kB'
+    auto parts = sl::utils::split(sl::utils::trim(val), ' ');
+    return parts.empty() ? 0 : sl::utils::parse_uint32(parts.front()) * static_cast<uint64_t>(1024);
+}
+
+void read_proc_status(sample& sa) {
+    auto src = sl::tinydir::file_source("/proc/self/status");
+    auto buf = sl::io::make_buffered_source(src);
+    for (;;) {
+        auto line = buf.read_line();
+        if (line.empty()) {
+            break;
+        }
+        auto colon = line.find(':');
+        if (std::string::npos == colon) {
+            continue;
+        }
+        auto name = line.substr(0, colon);
+        auto val = line.substr(colon + 1);
+        if ("VmRSS" == name) {
+            sa.rss_bytes = parse_kb(val);
+        } else if ("Threads" == name) {
+            sa.threads = sl::utils::parse_uint32(sl::utils::trim(val));
+        }
+    }
+}
+
+void write_all(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.length()) {
+        // client may already be gone, no SIGPIPE
+        auto res = ::send(fd, data.data() + written, data.length() - written, MSG_NOSIGNAL);
+        if (res < 0) {
+            if (EINTR == errno) continue;
+            throw support::exception(TRACEMSG("Socket write error: [" + remote::errno_str() + "]"));
+        }
+        written += static_cast<size_t>(res);
+    }
+}
+
+std::string line(const std::string& name, const std::string& labels, const std::string& value,
+        const std::string& timestamp) {
+    auto res = name;
+    if (!labels.empty()) {
+        res.append("{").append(labels).append("}");
+    }
+    res.append(" ").append(value);
+    if (!timestamp.empty()) {
+        res.append(" ").append(timestamp);
+    }
+    res.push_back('\n');
+    return res;
+}
+
+std::string header(const std::string& name, const std::string& type, const std::string& help) {
+    return "# HELP " + name + " " + help + "\n" + "# TYPE " + name + " " + type + "\n";
+}
+
+} // namespace
+
+// Process counters come from 'getrusage' and '/proc/self', they are read
+// from the exporter thread. Engine heap is not exported, engines are not
+// thread-safe and provide no heap stats call.
+class exporter {
+    std::string target;
+    std::chrono::seconds interval;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stop_requested = false;
+    std::thread worker;
+    int listen_fd = -1;
+
+public:
+    exporter(const std::string& target, uint32_t interval_secs) :
+    target(target),
+    interval(interval_secs > 0 ? interval_secs : 1) { }
+
+    exporter(const exporter&) = delete;
+
+    exporter& operator=(const exporter&) = delete;
+
+    ~exporter() STATICLIB_NOEXCEPT {
+        stop();
+    }
+
+    void start() {
+        if (sl::utils::starts_with(target, unix_socket_prefix)) {
+            listen_fd = remote::listen_socket(target.substr(unix_socket_prefix.length()));
+            worker = std::thread([this] {
+                serve();
+            });
+        } else {
+            worker = std::thread([this] {
+                append();
+            });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> guard{mtx};
+            stop_requested = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+        if (-1 != listen_fd) {
+            ::close(listen_fd);
+            ::unlink(target.substr(unix_socket_prefix.length()).c_str());
+            listen_fd = -1;
+        }
+    }
+
+private:
+    bool stopped() {
+        std::lock_guard<std::mutex> guard{mtx};
+        return stop_requested;
+    }
+
+    // answers each connection with a minimal HTTP response, so
+    // it can be scraped with 'curl --unix-socket'
+    void serve() {
+        while (!stopped()) {
+            struct pollfd pfd;
+            pfd.fd = listen_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(std::addressof(pfd), 1, 200) <= 0) {
+                continue;
+            }
+            int fd = ::accept(listen_fd, nullptr, nullptr);
+            if (-1 == fd) {
+                continue;
+            }
+            auto deferred = sl::support::defer([fd]() STATICLIB_NOEXCEPT {
+                ::close(fd);
+            });
+            struct timeval tv;
+            tv.tv_sec = 1;
+            tv.tv_usec = 0;
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, std::addressof(tv), sizeof(tv));
+            try {
+                // request line only, headers are ignored
+                auto buffer = std::string();
+                remote::read_line(fd, buffer);
+                auto body = format(collect(), std::string());
+                write_all(fd, std::string("HTTP/1.0 200 OK\r\n") +
+                        "Content-Type: text/plain; version=0.0.4\r\n" +
+                        "Content-Length: " + sl::support::to_string(body.length()) + "\r\n" +
+                        "\r\n" + body);
+            } catch (const std::exception& e) {
+                std::cerr << "WARNING: metrics request error: [" << e.what() << "]" << std::endl;
+            }
+        }
+    }
+
+    void append() {
+        auto next = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock{mtx};
+        while (!cv.wait_until(lock, next, [this] { return stop_requested; })) {
+            lock.unlock();
+            try {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+                auto text = format(collect(), sl::support::to_string(ms));
+                auto sink = sl::tinydir::file_sink(target, sl::tinydir::file_sink::open_mode::append);
+                sl::io::write_all(sink, {text.data(), text.length()});
+            } catch (const std::exception& e) {
+                std::cerr << "WARNING: metrics exporter stopped, error: [" << e.what() << "]" << std::endl;
+                return;
+            }
+            lock.lock();
+            next += interval;
+        }
+    }
+
+    sample collect() {
+        auto sa = sample();
+        struct rusage ru;
+        if (0 == ::getrusage(RUSAGE_SELF, std::addressof(ru))) {
+            sa.cpu_user_seconds = to_seconds(ru.ru_utime);
+            sa.cpu_system_seconds = to_seconds(ru.ru_stime);
+            sa.ctx_voluntary = static_cast<uint64_t>(ru.ru_nvcsw);
+            sa.ctx_involuntary = static_cast<uint64_t>(ru.ru_nivcsw);
+            sa.faults_minor = static_cast<uint64_t>(ru.ru_minflt);
+            sa.faults_major = static_cast<uint64_t>(ru.ru_majflt);
+        }
+        read_proc_status(sa);
+        sa.open_fds = sl::tinydir::list_directory("/proc/self/fd").size();
+        return sa;
+    }
+
+    static std::string format(const sample& sa, const std::string& ts) {
+        namespace ss = sl::support;
+        auto res = std::string();
+        res.append(header("wilton_process_resident_memory_bytes", "gauge", "Resident set size"));
+        res.append(line("wilton_process_resident_memory_bytes", "", ss::to_string(sa.rss_bytes), ts));
+        res.append(header("wilton_process_cpu_seconds_total", "counter", "CPU time spent"));
+        res.append(line("wilton_process_cpu_seconds_total", "mode=\"user\"", ss::to_string(sa.cpu_user_seconds), ts));
+        res.append(line("wilton_process_cpu_seconds_total", "mode=\"system\"", ss::to_string(sa.cpu_system_seconds), ts));
+        res.append(header("wilton_process_threads", "gauge", "Number of threads"));
+        res.append(line("wilton_process_threads", "", ss::to_string(sa.threads), ts));
+        res.append(header("wilton_process_open_fds", "gauge", "Number of open file descriptors"));
+        res.append(line("wilton_process_open_fds", "", ss::to_string(sa.open_fds), ts));
+        res.append(header("wilton_process_context_switches_total", "counter", "Context switches"));
+        res.append(line("wilton_process_context_switches_total", "kind=\"voluntary\"", ss::to_string(sa.ctx_voluntary), ts));
+        res.append(line("wilton_process_context_switches_total", "kind=\"involuntary\"", ss::to_string(sa.ctx_involuntary), ts));
+        res.append(header("wilton_process_page_faults_total", "counter", "Page faults"));
+        res.append(line("wilton_process_page_faults_total", "kind=\"minor\"", ss::to_string(sa.faults_minor), ts));
+        res.append(line("wilton_process_page_faults_total", "kind=\"major\"", ss::to_string(sa.faults_major), ts));
+        return res;
+    }
+};
+
+#else // !STATICLIB_LINUX
+
+class exporter {
+public:
+    exporter(const std::string&, uint32_t) { }
+
+    void start() {
+        throw support::exception(TRACEMSG("Metrics exporter is supported on Linux only"));
+    }
+
+    void stop() { }
+};
+
+#endif // STATICLIB_LINUX
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_METRICS_HPP */
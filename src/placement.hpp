@@ -0,0 +1,259 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   placement.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:38 AM
+ */
+
+#ifndef WILTON_CLI_PLACEMENT_HPP
+#define WILTON_CLI_PLACEMENT_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_LINUX
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "startup_trace.hpp"
+
+namespace wilton {
+namespace cli {
+namespace placement {
+
+// Applied to the launcher thread before 'wiltoncall_init', threads
+// created later by wilton and engines inherit affinity and scheduling.
+struct settings {
+    // '0-3,8,10-11'
+    std::string cpu_affinity;
+    int numa_node = -1;
+    bool mlockall = false;
+    // 'other', 'batch', 'idle', 'fifo' or 'rr'
+    std::string sched_policy;
+    int sched_priority = 0;
+
+    bool empty() const {
+        return cpu_affinity.empty() && numa_node < 0 && !mlockall && sched_policy.empty();
+    }
+};
+
+// values from 'placement' section of 'conf/config.json',
+// command line ones take precedence
+settings merge(const settings& cli, const sl::json::value& conf) {
+    auto res = cli;
+    if (sl::json::type::object != conf.json_type()) {
+        return res;
+    }
+    auto ctx = std::string("conf/config.json:placement");
+    for (auto& fi : conf.as_object()) {
+        if ("cpuAffinity" == fi.name()) {
+            if (res.cpu_affinity.empty()) {
+                res.cpu_affinity = fi.val().as_string_nonempty_or_throw(ctx + ".cpuAffinity");
+            }
+        } else if ("numaNode" == fi.name()) {
+            if (res.numa_node < 0) {
+                res.numa_node = static_cast<int>(fi.val().as_uint16_or_throw(ctx + ".numaNode"));
+            }
+        } else if ("mlockall" == fi.name()) {
+            res.mlockall = res.mlockall || fi.val().as_bool_or_throw(ctx + ".mlockall");
+        } else if ("schedPolicy" == fi.name()) {
+            if (res.sched_policy.empty()) {
+                res.sched_policy = fi.val().as_string_nonempty_or_throw(ctx + ".schedPolicy");
+            }
+        } else if ("schedPriority" == fi.name()) {
+            if (0 == res.sched_priority) {
+                res.sched_priority = fi.val().as_int32_or_throw(ctx + ".schedPriority");
+            }
+        } else throw support::exception(TRACEMSG("Unknown field: [" + fi.name() + "], " + ctx));
+    }
+    // priority is only used by real-time policies
+    if (0 != res.sched_priority && "fifo" != res.sched_policy && "rr" != res.sched_policy) {
+        throw support::exception(TRACEMSG("Scheduling priority: [" + sl::support::to_string(res.sched_priority) + "]" +
+                " requires 'fifo' or 'rr' scheduling policy, policy: [" + res.sched_policy + "], " + ctx));
+    }
+    return res;
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    auto res = std::vector<int>();
+    for (auto& part : sl::utils::split(sl::utils::trim(list), ',')) {
+        auto range = sl::utils::split(sl::utils::trim(part), '-');
+        if (1 == range.size()) {
+            res.push_back(static_cast<int>(sl::utils::parse_uint16(range.at(0))));
+        } else if (2 == range.size()) {
+            auto from = sl::utils::parse_uint16(range.at(0));
+            auto to = sl::utils::parse_uint16(range.at(1));
+            if (from > to) throw support::exception(TRACEMSG(
+                    "Invalid CPU range: [" + part + "], list: [" + list + "]"));
+            for (uint32_t i = from; i <= to; i++) {
+                res.push_back(static_cast<int>(i));
+            }
+        } else throw support::exception(TRACEMSG(
+                "Invalid CPU list: [" + list + "], expected format: '0-3,8'"));
+    }
+    return res;
+}
+
+#ifdef STATICLIB_LINUX
+
+namespace { // anonymous
+
+// not declared by glibc without libnuma headers
+const int mpol_bind = 2;
+
+std::string errno_str() {
+    return std::string(::strerror(errno));
+}
+
+int sched_policy_value(const std::string& name) {
+    if ("other" == name) return SCHED_OTHER;
+    if ("batch" == name) return SCHED_BATCH;
+    if ("idle" == name) return SCHED_IDLE;
+    if ("fifo" == name) return SCHED_FIFO;
+    if ("rr" == name) return SCHED_RR;
+    throw support::exception(TRACEMSG("Invalid scheduling policy: [" + name + "]," +
+            " supported: 'other', 'batch', 'idle', 'fifo', 'rr'"));
+}
+
+std::string sched_policy_name(int policy) {
+    switch (policy) {
+    case SCHED_OTHER: return "other";
+    case SCHED_BATCH: return "batch";
+    case SCHED_IDLE: return "idle";
+    case SCHED_FIFO: return "fifo";
+    case SCHED_RR: return "rr";
+    default: return sl::support::to_string(policy);
+    }
+}
+
+std::string read_node_cpulist(int node) {
+    auto path = "/sys/devices/system/node/node" + sl::support::to_string(node) + "/cpulist";
+    if (!sl::tinydir::path(path).exists()) throw support::exception(TRACEMSG(
+            "NUMA node not found: [" + sl::support::to_string(node) + "]"));
+    auto src = sl::tinydir::file_source(path);
+    auto buf = sl::io::make_buffered_source(src);
+    return sl::utils::trim(buf.read_line());
+}
+
+void set_affinity(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(std::addressof(set));
+    for (int cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) throw support::exception(TRACEMSG(
+                "CPU index out of range: [" + sl::support::to_string(cpu) + "]"));
+        CPU_SET(cpu, std::addressof(set));
+    }
+    if (0 != ::sched_setaffinity(0, sizeof(set), std::addressof(set))) throw support::exception(TRACEMSG(
+            "'sched_setaffinity' error: [" + errno_str() + "]"));
+}
+
+std::vector<sl::json::value> current_affinity() {
+    auto res = std::vector<sl::json::value>();
+    cpu_set_t set;
+    CPU_ZERO(std::addressof(set));
+    if (0 == ::sched_getaffinity(0, sizeof(set), std::addressof(set))) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, std::addressof(set))) {
+                res.emplace_back(static_cast<int64_t>(i));
+            }
+        }
+    }
+    return res;
+}
+
+void bind_memory(int node) {
+    const size_t bits = sizeof(unsigned long) * 8;
+    auto mask = std::vector<unsigned long>(static_cast<size_t>(node) / bits + 1, 0);
+    mask[static_cast<size_t>(node) / bits] = 1UL << (static_cast<size_t>(node) % bits);
+    auto err = ::syscall(SYS_set_mempolicy, mpol_bind, mask.data(), mask.size() * bits + 1);
+    if (0 != err) throw support::exception(TRACEMSG(
+            "'set_mempolicy' error, node: [" + sl::support::to_string(node) + "]," +
+            " error: [" + errno_str() + "]"));
+}
+
+} // namespace
+
+// returns effective placement for '--print-config'
+sl::json::value apply(const settings& st) {
+    trace::phase ph("placement::apply");
+    if (st.numa_node >= 0) {
+        bind_memory(st.numa_node);
+    }
+    if (!st.cpu_affinity.empty()) {
+        set_affinity(parse_cpu_list(st.cpu_affinity));
+    } else if (st.numa_node >= 0) {
+        // run on CPUs local to the memory node
+        set_affinity(parse_cpu_list(read_node_cpulist(st.numa_node)));
+    }
+    if (st.mlockall) {
+        if (0 != ::mlockall(MCL_CURRENT | MCL_FUTURE)) throw support::exception(TRACEMSG(
+                "'mlockall' error: [" + errno_str() + "]"));
+    }
+    if (!st.sched_policy.empty()) {
+        struct sched_param param;
+        std::memset(std::addressof(param), '\0', sizeof(param));
+        param.sched_priority = st.sched_priority;
+        if (0 != ::sched_setscheduler(0, sched_policy_value(st.sched_policy), std::addressof(param))) {
+            throw support::exception(TRACEMSG("'sched_setscheduler' error, policy: [" + st.sched_policy + "]," +
+                    " priority: [" + sl::support::to_string(st.sched_priority) + "], error: [" + errno_str() + "]"));
+        }
+    }
+    struct sched_param cur;
+    std::memset(std::addressof(cur), '\0', sizeof(cur));
+    ::sched_getparam(0, std::addressof(cur));
+    return {
+        {"cpuAffinity", current_affinity()},
+        {"numaNode", static_cast<int64_t>(st.numa_node)},
+        {"mlockall", st.mlockall},
+        {"schedPolicy", sched_policy_name(::sched_getscheduler(0))},
+        {"schedPriority", static_cast<int64_t>(cur.sched_priority)}
+    };
+}
+
+#else // !STATICLIB_LINUX
+
+sl::json::value apply(const settings& st) {
+    if (!st.empty()) throw support::exception(TRACEMSG(
+            "CPU affinity, NUMA, mlockall and scheduling options are supported on Linux only"));
+    return sl::json::value();
+}
+
+#endif // STATICLIB_LINUX
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_PLACEMENT_HPP */
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   readahead.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:44 AM
+ */
+
+#ifndef WILTON_CLI_READAHEAD_HPP
+#define WILTON_CLI_READAHEAD_HPP
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/support.hpp"
+
+#include "startup_trace.hpp"
+
+namespace wilton {
+namespace cli {
+namespace readahead {
+
+#if defined(STATICLIB_WINDOWS)
+const std::string shared_lib_prefix = "";
+const std::string shared_lib_postfix = ".dll";
+#elif defined(STATICLIB_MAC)
+const std::string shared_lib_prefix = "lib";
+const std::string shared_lib_postfix = ".dylib";
+#else
+const std::string shared_lib_prefix = "lib";
+const std::string shared_lib_postfix = ".so";
+#endif
+
+// path of the module loaded with 'wilton_dyload' from 'WILTON_HOME/bin'
+std::string module_path(const std::string& wilton_home, const std::string& name) {
+    return wilton_home + "bin/" + shared_lib_prefix + name + shared_lib_postfix;
+}
+
+// Asks kernel to read the specified files into page cache, so later
+// 'dlopen' and ZIP reads do not wait on disk. Files are processed in order
+// on a background thread, missing files are ignored. Thread is joined
+// in destructor, hints are issued quickly, actual I/O is done by kernel.
+class prefetcher {
+    std::thread worker;
+
+public:
+    prefetcher() { }
+
+    prefetcher(std::vector<std::string> files) {
+        if (files.empty()) {
+            return;
+        }
+        worker = std::thread([](std::vector<std::string> paths) {
+            trace::phase ph("readahead", sl::support::to_string(paths.size()));
+            for (auto& pa : paths) {
+                advise_willneed(pa);
+            }
+        }, std::move(files));
+    }
+
+    prefetcher(const prefetcher&) = delete;
+
+    prefetcher& operator=(const prefetcher&) = delete;
+
+    ~prefetcher() STATICLIB_NOEXCEPT {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+private:
+#ifdef STATICLIB_LINUX
+    static void advise_willneed(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (-1 == fd) {
+            return;
+        }
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        ::close(fd);
+    }
+#else // !STATICLIB_LINUX
+    static void advise_willneed(const std::string&) {
+        // no-op, OS readahead is used
+    }
+#endif // STATICLIB_LINUX
+};
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_READAHEAD_HPP */
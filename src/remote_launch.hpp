@@ -0,0 +1,562 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   remote_launch.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:24 AM
+ */
+
+#ifndef WILTON_CLI_REMOTE_LAUNCH_HPP
+#define WILTON_CLI_REMOTE_LAUNCH_HPP
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // !STATICLIB_WINDOWS
+
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "file_stamp.hpp"
+
+#if defined(STATICLIB_MAC)
+extern char** environ;
+#endif // STATICLIB_MAC
+
+namespace wilton {
+namespace cli {
+namespace remote {
+
+// Launch request, sent by the client as a single JSON line, client stdio
+// descriptors are attached to it with SCM_RIGHTS. Server replies with
+// '{"pid": N}' line when the job is started and '{"exitCode": N}' line
+// when it is finished.
+struct request {
+    std::string script;
+    std::vector<std::string> args;
+    std::vector<std::pair<std::string, std::string>> env;
+    std::string cwd;
+    std::array<int, 3> stdio_fds = {{-1, -1, -1}};
+
+    std::string to_json() const {
+        auto args_json = std::vector<sl::json::value>();
+        for (auto& ar : args) {
+            args_json.emplace_back(ar);
+        }
+        auto env_json = std::vector<sl::json::field>();
+        for (auto& pa : env) {
+            env_json.emplace_back(pa.first, pa.second);
+        }
+        return sl::json::dumps({
+            {"script", script},
+            {"args", std::move(args_json)},
+            {"env", std::move(env_json)},
+            {"cwd", cwd}
+        });
+    }
+
+    static request from_json(const std::string& line) {
+        auto json = sl::json::loads(line);
+        auto res = request();
+        for (auto& fi : json.as_object_or_throw("request")) {
+            if ("script" == fi.name()) {
+                res.script = fi.val().as_string_nonempty_or_throw("request:script");
+            } else if ("args" == fi.name()) {
+                for (auto& ar : fi.val().as_array_or_throw("request:args")) {
+                    res.args.emplace_back(ar.as_string_or_throw("request:args"));
+                }
+            } else if ("env" == fi.name()) {
+                for (auto& en : fi.val().as_object_or_throw("request:env")) {
+                    res.env.emplace_back(en.name(), en.as_string_or_throw(en.name()));
+                }
+            } else if ("cwd" == fi.name()) {
+                res.cwd = fi.val().as_string_nonempty_or_throw("request:cwd");
+            }
+        }
+        return res;
+    }
+};
+
+#ifndef STATICLIB_WINDOWS
+
+// client sends the whole request right after connect, servers read
+// requests one at a time, so a silent client must not block them for long
+const int request_timeout_millis = 5000;
+
+std::string errno_str() {
+    return std::string(std::strerror(errno));
+}
+
+// 'waitpid' status -> shell-like exit code
+int status_to_exit_code(int status) {
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return 1;
+}
+
+void write_line(int fd, const std::string& line) {
+    auto data = line + "\n";
+    size_t written = 0;
+    while (written < data.length()) {
+        auto res = ::write(fd, data.data() + written, data.length() - written);
+        if (res < 0) {
+            if (EINTR == errno) continue;
+            throw support::exception(TRACEMSG("Socket write error: [" + errno_str() + "]"));
+        }
+        written += static_cast<size_t>(res);
+    }
+}
+
+// reads until newline, 'buffer' keeps data received after it, empty result means EOF
+std::string read_line(int fd, std::string& buffer) {
+    for (;;) {
+        auto pos = buffer.find('\n');
+        if (std::string::npos != pos) {
+            auto res = buffer.substr(0, pos);
+            buffer = buffer.substr(pos + 1);
+            return res;
+        }
+        std::array<char, 4096> buf;
+        auto res = ::read(fd, buf.data(), buf.size());
+        if (res < 0) {
+            if (EINTR == errno) continue;
+            if (EAGAIN == errno || EWOULDBLOCK == errno) throw support::exception(TRACEMSG(
+                    "Socket read timeout"));
+            throw support::exception(TRACEMSG("Socket read error: [" + errno_str() + "]"));
+        }
+        if (0 == res) {
+            return std::string();
+        }
+        buffer.append(buf.data(), static_cast<size_t>(res));
+    }
+}
+
+sockaddr_un socket_address(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(std::addressof(addr), '\0', sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(addr.sun_path)) throw support::exception(TRACEMSG(
+            "Socket path is too long: [" + path + "]"));
+    std::memcpy(addr.sun_path, path.c_str(), path.length());
+    return addr;
+}
+
+// socket file left by a crashed server is removed, files of other
+// types and sockets some server is still listening on are kept
+void remove_stale_socket(const std::string& path) {
+    struct stat st;
+    if (0 != ::lstat(path.c_str(), std::addressof(st))) {
+        if (ENOENT == errno) {
+            return;
+        }
+        throw support::exception(TRACEMSG("Socket path check error, path: [" + path + "]," +
+                " error: [" + errno_str() + "]"));
+    }
+    if (!S_ISSOCK(st.st_mode)) throw support::exception(TRACEMSG(
+            "Specified socket path exists and is not a socket, path: [" + path + "]"));
+    auto addr = socket_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (-1 == fd) throw support::exception(TRACEMSG(
+            "Socket create error: [" + errno_str() + "]"));
+    auto err = ::connect(fd, reinterpret_cast<sockaddr*>(std::addressof(addr)), sizeof(addr));
+    auto connect_errno = errno;
+    ::close(fd);
+    if (0 == err) throw support::exception(TRACEMSG(
+            "Specified socket is already in use, path: [" + path + "]"));
+    if (ECONNREFUSED != connect_errno) throw support::exception(TRACEMSG(
+            "Cannot check existing socket, path: [" + path + "]," +
+            " error: [" + std::string(std::strerror(connect_errno)) + "]"));
+    ::unlink(path.c_str());
+}
+
+// socket file is only accessible to the owner, connections are
+// additionally checked with 'peer_is_same_user'
+int listen_socket(const std::string& path) {
+    auto addr = socket_address(path);
+    remove_stale_socket(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (-1 == fd) throw support::exception(TRACEMSG(
+            "Socket create error: [" + errno_str() + "]"));
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    auto err_bind = ::bind(fd, reinterpret_cast<sockaddr*>(std::addressof(addr)), sizeof(addr));
+    if (0 != err_bind) {
+        auto msg = errno_str();
+        ::close(fd);
+        throw support::exception(TRACEMSG("Socket bind error, path: [" + path + "]," +
+                " error: [" + msg + "]"));
+    }
+    if (0 != ::chmod(path.c_str(), S_IRUSR | S_IWUSR)) {
+        auto msg = errno_str();
+        ::close(fd);
+        ::unlink(path.c_str());
+        throw support::exception(TRACEMSG("Socket chmod error, path: [" + path + "]," +
+                " error: [" + msg + "]"));
+    }
+    if (0 != ::listen(fd, 128)) {
+        auto msg = errno_str();
+        ::close(fd);
+        throw support::exception(TRACEMSG("Socket listen error, path: [" + path + "]," +
+                " error: [" + msg + "]"));
+    }
+    return fd;
+}
+
+// launch requests run code with server credentials, so they are
+// only accepted from the processes of the same user
+bool peer_is_same_user(int fd) {
+#if defined(STATICLIB_LINUX) || defined(STATICLIB_ANDROID)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (0 != ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, std::addressof(cred), std::addressof(len))) {
+        return false;
+    }
+    return ::geteuid() == cred.uid;
+#else // !STATICLIB_LINUX
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (0 != ::getpeereid(fd, std::addressof(uid), std::addressof(gid))) {
+        return false;
+    }
+    return ::geteuid() == uid;
+#endif // STATICLIB_LINUX
+}
+
+int connect_socket(const std::string& path) {
+    auto addr = socket_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (-1 == fd) throw support::exception(TRACEMSG(
+            "Socket create error: [" + errno_str() + "]"));
+    auto err = ::connect(fd, reinterpret_cast<sockaddr*>(std::addressof(addr)), sizeof(addr));
+    if (0 != err) {
+        auto msg = errno_str();
+        ::close(fd);
+        throw support::exception(TRACEMSG("Socket connect error, path: [" + path + "]," +
+                " error: [" + msg + "]"));
+    }
+    return fd;
+}
+
+void send_request(int fd, const request& req) {
+    auto data = req.to_json() + "\n";
+    // descriptors are attached to the first byte of the message
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(data.data());
+    iov.iov_len = 1;
+    std::array<int, 3> fds = {{STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO}};
+    std::array<char, CMSG_SPACE(sizeof(fds))> control;
+    std::memset(control.data(), '\0', control.size());
+    struct msghdr msg;
+    std::memset(std::addressof(msg), '\0', sizeof(msg));
+    msg.msg_iov = std::addressof(iov);
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(std::addressof(msg));
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(fds));
+    ssize_t sent = -1;
+    do {
+        sent = ::sendmsg(fd, std::addressof(msg), 0);
+    } while (sent < 0 && EINTR == errno);
+    if (1 != sent) throw support::exception(TRACEMSG(
+            "Socket send error: [" + errno_str() + "]"));
+    write_line(fd, data.substr(1, data.length() - 2));
+}
+
+void set_receive_timeout(int fd, int millis) {
+    struct timeval tv;
+    tv.tv_sec = millis / 1000;
+    tv.tv_usec = (millis % 1000) * 1000;
+    if (0 != ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, std::addressof(tv), sizeof(tv))) {
+        throw support::exception(TRACEMSG("Socket timeout set error: [" + errno_str() + "]"));
+    }
+}
+
+void close_fds(std::array<int, 3>& fds) {
+    for (auto& fd : fds) {
+        if (-1 != fd) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+// received descriptors are closed on any error, request is read with
+// 'request_timeout_millis' deadline for each read call
+request receive_request(int fd) {
+    set_receive_timeout(fd, request_timeout_millis);
+    char first = '\0';
+    struct iovec iov;
+    iov.iov_base = std::addressof(first);
+    iov.iov_len = 1;
+    std::array<int, 3> fds = {{-1, -1, -1}};
+    std::array<char, CMSG_SPACE(sizeof(fds))> control;
+    std::memset(control.data(), '\0', control.size());
+    struct msghdr msg;
+    std::memset(std::addressof(msg), '\0', sizeof(msg));
+    msg.msg_iov = std::addressof(iov);
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    ssize_t received = -1;
+    do {
+        received = ::recvmsg(fd, std::addressof(msg), 0);
+    } while (received < 0 && EINTR == errno);
+    auto recv_errno = errno;
+    // descriptors may be attached even if the message is not valid
+    size_t fds_count = 0;
+    auto first_cmsg = received > 0 ? CMSG_FIRSTHDR(std::addressof(msg)) : nullptr;
+    for (struct cmsghdr* cmsg = first_cmsg; nullptr != cmsg; cmsg = CMSG_NXTHDR(std::addressof(msg), cmsg)) {
+        if (SOL_SOCKET != cmsg->cmsg_level || SCM_RIGHTS != cmsg->cmsg_type) {
+            continue;
+        }
+        auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; i++) {
+            int rfd = -1;
+            std::memcpy(std::addressof(rfd), CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (fds_count < fds.size()) {
+                fds[fds_count] = rfd;
+            } else {
+                ::close(rfd);
+            }
+            fds_count += 1;
+        }
+    }
+    if (1 != received) {
+        close_fds(fds);
+        if (0 == received) throw support::exception(TRACEMSG(
+                "Connection closed by client"));
+        throw support::exception(TRACEMSG("Socket receive error: [" +
+                std::string(std::strerror(recv_errno)) + "]"));
+    }
+    if (fds.size() != fds_count) {
+        close_fds(fds);
+        throw support::exception(TRACEMSG("Client stdio descriptors not received"));
+    }
+    try {
+        auto buffer = std::string(1, first);
+        auto line = read_line(fd, buffer);
+        auto res = request::from_json(line);
+        res.stdio_fds = fds;
+        set_receive_timeout(fd, 0);
+        return res;
+    } catch (...) {
+        close_fds(fds);
+        throw;
+    }
+}
+
+void close_stdio_fds(request& req) {
+    close_fds(req.stdio_fds);
+}
+
+// switches current process to the client environment, used in job processes
+void apply_request_env(const request& req) {
+#ifdef STATICLIB_MAC
+    for (char** el = environ; nullptr != el && nullptr != *el; el = environ) {
+        auto var = std::string(*el);
+        ::unsetenv(var.substr(0, var.find('=')).c_str());
+    }
+#else // !STATICLIB_MAC
+    ::clearenv();
+#endif // STATICLIB_MAC
+    for (auto& pa : req.env) {
+        ::setenv(pa.first.c_str(), pa.second.c_str(), 1);
+    }
+    if (0 != ::chdir(req.cwd.c_str())) throw support::exception(TRACEMSG(
+            "Cannot change working directory, path: [" + req.cwd + "]," +
+            " error: [" + errno_str() + "]"));
+}
+
+namespace { // anonymous
+
+int signal_pipe_write_fd = -1;
+
+void write_signal_to_pipe(int signum) {
+    auto saved_errno = errno;
+    auto byte = static_cast<char>(signum);
+    auto res = ::write(signal_pipe_write_fd, std::addressof(byte), 1);
+    (void) res;
+    errno = saved_errno;
+}
+
+} // namespace
+
+// Server loops wait in 'poll' on sockets and on the read end of this pipe,
+// signal handlers only write the signal number into it. Single instance
+// per process, handlers are reset to default in destructor.
+class signal_pipe {
+    std::array<int, 2> fds = {{-1, -1}};
+    std::vector<int> signals;
+
+public:
+    signal_pipe(std::vector<int> signals_list) :
+    signals(std::move(signals_list)) {
+        if (0 != ::pipe(fds.data())) throw support::exception(TRACEMSG(
+                "Signal pipe create error: [" + errno_str() + "]"));
+        for (int fd : fds) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        signal_pipe_write_fd = fds[1];
+        for (int sig : signals) {
+            struct sigaction sa;
+            std::memset(std::addressof(sa), '\0', sizeof(sa));
+            sa.sa_handler = write_signal_to_pipe;
+            ::sigemptyset(std::addressof(sa.sa_mask));
+            sa.sa_flags = SA_RESTART | (SIGCHLD == sig ? SA_NOCLDSTOP : 0);
+            ::sigaction(sig, std::addressof(sa), nullptr);
+        }
+    }
+
+    signal_pipe(const signal_pipe&) = delete;
+
+    signal_pipe& operator=(const signal_pipe&) = delete;
+
+    ~signal_pipe() STATICLIB_NOEXCEPT {
+        close_fds();
+    }
+
+    int read_fd() const {
+        return fds[0];
+    }
+
+    // returns signals received since the previous call
+    std::vector<int> drain() {
+        auto res = std::vector<int>();
+        std::array<char, 64> buf;
+        for (;;) {
+            auto len = ::read(fds[0], buf.data(), buf.size());
+            if (len <= 0) {
+                return res;
+            }
+            for (ssize_t i = 0; i < len; i++) {
+                res.push_back(static_cast<int>(buf[i]));
+            }
+        }
+    }
+
+    // called in forked children, job gets default signal handling
+    void close_fds() {
+        for (int sig : signals) {
+            std::signal(sig, SIG_DFL);
+        }
+        signal_pipe_write_fd = -1;
+        for (auto& fd : fds) {
+            if (-1 != fd) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+};
+
+namespace { // anonymous
+
+volatile sig_atomic_t client_job_pid = 0;
+
+void forward_signal(int signum) {
+    if (client_job_pid > 0) {
+        ::kill(static_cast<pid_t>(client_job_pid), signum);
+    }
+}
+
+} // namespace
+
+// thin client: passes script, args, env, cwd and own stdio to the server
+// and returns exit code of the remote job
+uint8_t run_client(const std::string& socket_path, const std::string& script,
+        const std::vector<std::string>& args) {
+    auto req = request();
+    req.script = script;
+    req.args = args;
+    req.cwd = current_directory();
+    for (char** el = environ; nullptr != el && nullptr != *el; el++) {
+        auto var = std::string(*el);
+        auto pos = var.find('=');
+        if (std::string::npos != pos && pos > 0) {
+            req.env.emplace_back(var.substr(0, pos), var.substr(pos + 1));
+        }
+    }
+    int fd = connect_socket(socket_path);
+    auto deferred = sl::support::defer([fd]() STATICLIB_NOEXCEPT {
+        ::close(fd);
+    });
+    send_request(fd, req);
+    auto buffer = std::string();
+    for (;;) {
+        auto line = read_line(fd, buffer);
+        if (line.empty()) throw support::exception(TRACEMSG(
+                "Connection closed by server, socket: [" + socket_path + "]"));
+        auto json = sl::json::loads(line);
+        auto& err = json["error"];
+        if (sl::json::type::string == err.json_type()) throw support::exception(TRACEMSG(
+                "Remote launch error: [" + err.as_string() + "]"));
+        auto& pid = json["pid"];
+        if (sl::json::type::integer == pid.json_type()) {
+            client_job_pid = static_cast<sig_atomic_t>(pid.as_int64());
+            std::signal(SIGINT, forward_signal);
+            std::signal(SIGTERM, forward_signal);
+            continue;
+        }
+        auto& code = json["exitCode"];
+        if (sl::json::type::integer == code.json_type()) {
+            return static_cast<uint8_t>(code.as_int64());
+        }
+    }
+}
+
+#else // STATICLIB_WINDOWS
+
+uint8_t run_client(const std::string&, const std::string&, const std::vector<std::string>&) {
+    throw support::exception(TRACEMSG("Remote launch is not supported on this platform"));
+}
+
+#endif // !STATICLIB_WINDOWS
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_REMOTE_LAUNCH_HPP */
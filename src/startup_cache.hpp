@@ -0,0 +1,168 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   startup_cache.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:21 AM
+ */
+
+#ifndef WILTON_CLI_STARTUP_CACHE_HPP
+#define WILTON_CLI_STARTUP_CACHE_HPP
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "file_stamp.hpp"
+#include "startup_trace.hpp"
+
+namespace wilton {
+namespace cli {
+namespace cache {
+
+struct entry {
+    std::string startmod;
+    std::vector<sl::json::field> paths;
+    std::vector<sl::json::value> packages;
+};
+
+// on-disk cache of the resolved requireJs 'paths' and 'packages'
+class startup_cache {
+    std::string file;
+    std::string fingerprint;
+    // cache stays read-only on hits, so counters over launches are not kept
+    bool current_launch_hit = false;
+
+public:
+    startup_cache(const std::string& dir, const std::string& key, const std::string& fingerprint) :
+    file(dir + "/startup_" + hash_fnv1a_hex(key) + ".json"),
+    fingerprint(fingerprint) { }
+
+    // read-only, warm launches do not write to the cache dir
+    sl::support::optional<entry> lookup() {
+        trace::phase ph("startup_cache::lookup");
+        auto res = entry();
+        auto fp = std::string();
+        try {
+            if (!read_file_stamp(file).exists) {
+                return sl::support::optional<entry>();
+            }
+            auto src = sl::tinydir::file_source(file);
+            auto json = sl::json::load(src);
+            for (auto& fi : json.as_object_or_throw(file)) {
+                if ("fingerprint" == fi.name()) {
+                    fp = fi.val().as_string();
+                } else if ("startmod" == fi.name()) {
+                    res.startmod = fi.val().as_string();
+                } else if ("paths" == fi.name()) {
+                    res.paths = std::move(fi.val().as_object_or_throw(file + ":paths"));
+                } else if ("packages" == fi.name()) {
+                    res.packages = std::move(fi.val().as_array_or_throw(file + ":packages"));
+                }
+            }
+        } catch (const std::exception&) {
+            // broken cache file is treated as a miss
+            return sl::support::optional<entry>();
+        }
+        if (fp != fingerprint || res.startmod.empty()) {
+            return sl::support::optional<entry>();
+        }
+        current_launch_hit = true;
+        return sl::support::make_optional(std::move(res));
+    }
+
+    void store(const entry& en) {
+        trace::phase ph("startup_cache::store");
+        current_launch_hit = false;
+        write(en);
+    }
+
+    sl::json::value status() const {
+        return {
+            {"file", file},
+            {"currentLaunchHit", current_launch_hit}
+        };
+    }
+
+private:
+    void write(const entry& en) {
+        auto paths = std::vector<sl::json::field>();
+        for (auto& fi : en.paths) {
+            paths.emplace_back(fi.name(), fi.val().clone());
+        }
+        auto packages = std::vector<sl::json::value>();
+        for (auto& pa : en.packages) {
+            packages.emplace_back(pa.clone());
+        }
+        auto json = sl::json::dumps({
+            {"fingerprint", fingerprint},
+            {"startmod", en.startmod},
+            {"paths", std::move(paths)},
+            {"packages", std::move(packages)}
+        });
+        // write and rename, concurrent launches may use the same entry
+        auto rsg = sl::utils::random_string_generator();
+        auto tmp = file + "." + rsg.generate(8) + ".tmp";
+        try {
+            {
+                auto sink = sl::tinydir::path(tmp).open_write();
+                sl::io::write_all(sink, {json.data(), json.length()});
+            }
+#ifdef STATICLIB_WINDOWS
+            std::remove(file.c_str());
+#endif // STATICLIB_WINDOWS
+            if (0 != std::rename(tmp.c_str(), file.c_str())) {
+                std::remove(tmp.c_str());
+            }
+        } catch (const std::exception& e) {
+            std::remove(tmp.c_str());
+            std::cerr << "WARNING: cannot write startup cache file: [" << file << "]," <<
+                    " message: [" << e.what() << "]" << std::endl;
+        }
+    }
+};
+
+// input files are checked with a single 'stat' call each
+std::string fingerprint(const std::vector<std::string>& values, const std::vector<std::string>& files) {
+    auto res = std::string();
+    for (auto& va : values) {
+        res.append(va);
+        res.push_back('\n');
+    }
+    for (auto& fi : files) {
+        res.append(fi);
+        res.push_back('=');
+        res.append(read_file_stamp(fi).to_string());
+        res.push_back('\n');
+    }
+    return res;
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_STARTUP_CACHE_HPP */
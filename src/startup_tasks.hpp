@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   startup_tasks.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:23 AM
+ */
+
+#ifndef WILTON_CLI_STARTUP_TASKS_HPP
+#define WILTON_CLI_STARTUP_TASKS_HPP
+
+#include <functional>
+#include <future>
+#include <utility>
+
+namespace wilton {
+namespace cli {
+namespace tasks {
+
+// Startup phases that do not depend on each other run on separate threads
+// and are joined with 'get()' before 'wiltoncall_init'. Exceptions are rethrown
+// from 'get()', so errors are reported the same way as with sequential calls.
+// In serial mode the task is deferred and runs on the joining thread.
+template<typename T>
+std::future<T> launch(bool serial, std::function<T()> fun) {
+    auto policy = serial ? std::launch::deferred : std::launch::async;
+    return std::async(policy, std::move(fun));
+}
+
+template<typename T>
+std::future<T> ready(T&& value) {
+    std::promise<T> pr;
+    pr.set_value(std::move(value));
+    return pr.get_future();
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_STARTUP_TASKS_HPP */
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   startup_trace.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:19 AM
+ */
+
+#ifndef WILTON_CLI_STARTUP_TRACE_HPP
+#define WILTON_CLI_STARTUP_TRACE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_WINDOWS
+#include "staticlib/support/windows.hpp"
+#else // !STATICLIB_WINDOWS
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+namespace wilton {
+namespace cli {
+namespace trace {
+
+struct event {
+    std::string name;
+    std::string arg;
+    int64_t start_us;
+    int64_t duration_us;
+    uint32_t tid;
+
+    event(const std::string& name, const std::string& arg, int64_t start_us,
+            int64_t duration_us, uint32_t tid) :
+    name(name),
+    arg(arg),
+    start_us(start_us),
+    duration_us(duration_us),
+    tid(tid) { }
+};
+
+class tracer {
+    std::mutex mtx;
+    bool enabled = false;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::map<std::thread::id, uint32_t> tids;
+    std::vector<event> events;
+
+public:
+    void enable() {
+        std::lock_guard<std::mutex> guard{mtx};
+        enabled = true;
+    }
+
+    bool is_enabled() {
+        std::lock_guard<std::mutex> guard{mtx};
+        return enabled;
+    }
+
+    int64_t now_us() {
+        auto elapsed = std::chrono::steady_clock::now() - origin;
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+
+    void record(const std::string& name, const std::string& arg, int64_t start_us, int64_t end_us) {
+        std::lock_guard<std::mutex> guard{mtx};
+        if (!enabled) {
+            return;
+        }
+        auto id = std::this_thread::get_id();
+        auto it = tids.find(id);
+        if (tids.end() == it) {
+            auto pa = tids.insert(std::make_pair(id, static_cast<uint32_t>(tids.size() + 1)));
+            it = pa.first;
+        }
+        events.emplace_back(name, arg, start_us, end_us - start_us, it->second);
+    }
+
+    void write_json(const std::string& path) {
+        std::lock_guard<std::mutex> guard{mtx};
+#ifdef STATICLIB_WINDOWS
+        auto pid = static_cast<int64_t>(::GetCurrentProcessId());
+#else // !STATICLIB_WINDOWS
+        auto pid = static_cast<int64_t>(::getpid());
+#endif // STATICLIB_WINDOWS
+        auto vec = std::vector<sl::json::value>();
+        for (auto& ev : events) {
+            auto fields = std::vector<sl::json::field>();
+            fields.emplace_back("name", ev.name);
+            fields.emplace_back("cat", "startup");
+            fields.emplace_back("ph", "X");
+            fields.emplace_back("ts", ev.start_us);
+            fields.emplace_back("dur", ev.duration_us);
+            fields.emplace_back("pid", pid);
+            fields.emplace_back("tid", static_cast<int64_t>(ev.tid));
+            if (!ev.arg.empty()) {
+                auto args = std::vector<sl::json::field>();
+                args.emplace_back("name", ev.arg);
+                fields.emplace_back("args", std::move(args));
+            }
+            vec.emplace_back(std::move(fields));
+        }
+        auto json = sl::json::dumps({
+            {"traceEvents", std::move(vec)},
+            {"displayTimeUnit", "ms"}
+        });
+        auto sink = sl::tinydir::path(path).open_write();
+        sl::io::write_all(sink, {json.data(), json.length()});
+    }
+
+    void print_summary(std::ostream& out) {
+        std::lock_guard<std::mutex> guard{mtx};
+        out << "Startup trace (ms):" << std::endl;
+        int64_t end_us = 0;
+        for (auto& ev : events) {
+            auto line = std::string();
+            line.resize(32);
+            auto len = std::snprintf(std::addressof(line.front()), line.length(), "%10.3f %10.3f  ",
+                    static_cast<double>(ev.start_us) / 1000, static_cast<double>(ev.duration_us) / 1000);
+            line.resize(static_cast<size_t>(len > 0 ? len : 0));
+            out << line << ev.name;
+            if (!ev.arg.empty()) {
+                out << " [" << ev.arg << "]";
+            }
+            out << std::endl;
+            end_us = std::max(end_us, ev.start_us + ev.duration_us);
+        }
+        out << "Total: " << static_cast<double>(end_us) / 1000 << " ms" << std::endl;
+    }
+};
+
+tracer& global_tracer() {
+    static tracer instance;
+    return instance;
+}
+
+class phase {
+    std::string name;
+    std::string arg;
+    int64_t start_us;
+
+public:
+    phase(const std::string& name, const std::string& arg = std::string()) :
+    name(name),
+    arg(arg),
+    start_us(global_tracer().now_us()) { }
+
+    ~phase() STATICLIB_NOEXCEPT {
+        try {
+            global_tracer().record(name, arg, start_us, global_tracer().now_us());
+        } catch(...) {
+            // ignore
+        }
+    }
+
+    phase(const phase&) = delete;
+
+    phase& operator=(const phase&) = delete;
+};
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_STARTUP_TRACE_HPP */
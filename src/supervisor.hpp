@@ -0,0 +1,320 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   supervisor.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:36 AM
+ */
+
+#ifndef WILTON_CLI_SUPERVISOR_HPP
+#define WILTON_CLI_SUPERVISOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // !STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "remote_launch.hpp"
+
+namespace wilton {
+namespace cli {
+namespace supervisor {
+
+struct settings {
+    uint32_t workers = 0;
+    // 'host:port' or ':port', opened once and inherited by all workers,
+    // wilton modules do not consume LISTEN_FDS
+    std::vector<std::string> listen;
+};
+
+struct pool_result {
+    bool is_worker = false;
+    uint32_t worker_id = 0;
+    uint8_t exit_code = 0;
+};
+
+const std::string worker_id_env_var = "WILTON_WORKER_ID";
+const std::string workers_count_env_var = "WILTON_WORKERS_COUNT";
+
+#ifndef STATICLIB_WINDOWS
+
+namespace { // anonymous
+
+struct worker_slot {
+    pid_t pid = 0;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point restart_at;
+    std::chrono::milliseconds backoff{0};
+    bool finished = false;
+};
+
+const std::chrono::milliseconds backoff_min{100};
+const std::chrono::milliseconds backoff_max{30000};
+// worker running longer than this is considered healthy, backoff is reset
+const std::chrono::seconds stable_uptime{60};
+
+int open_listen_socket(const std::string& addr) {
+    auto colon = addr.rfind(':');
+    if (std::string::npos == colon || colon + 1 == addr.length()) throw support::exception(TRACEMSG(
+            "Invalid listen address, expected 'host:port', value: [" + addr + "]"));
+    auto host = addr.substr(0, colon);
+    if (sl::utils::starts_with(host, "[") && sl::utils::ends_with(host, "]")) {
+        host = host.substr(1, host.length() - 2);
+    }
+    auto port = addr.substr(colon + 1);
+    struct addrinfo hints;
+    std::memset(std::addressof(hints), '\0', sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    struct addrinfo* res = nullptr;
+    auto err = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+            std::addressof(hints), std::addressof(res));
+    if (0 != err) throw support::exception(TRACEMSG(
+            "Cannot resolve listen address: [" + addr + "], error: [" + ::gai_strerror(err) + "]"));
+    auto deferred = sl::support::defer([res]() STATICLIB_NOEXCEPT {
+        ::freeaddrinfo(res);
+    });
+    int fd = ::socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (-1 == fd) throw support::exception(TRACEMSG(
+            "Cannot create socket, address: [" + addr + "], error: [" + remote::errno_str() + "]"));
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, std::addressof(one), sizeof(one));
+    if (-1 == ::bind(fd, res->ai_addr, res->ai_addrlen) || -1 == ::listen(fd, SOMAXCONN)) {
+        auto msg = remote::errno_str();
+        ::close(fd);
+        throw support::exception(TRACEMSG(
+                "Cannot listen on address: [" + addr + "], error: [" + msg + "]"));
+    }
+    return fd;
+}
+
+// systemd socket activation convention: fds start at 3, all sockets
+// are moved above the target range first, so 'dup2' cannot overwrite
+// a socket that is not yet moved. Other descriptors in the target range
+// are replaced, so options that keep an fd open for the script (stdin
+// script memfd) cannot be used with workers. Sockets are only passed
+// on, it is up to the script to pick them up.
+void setup_worker(uint32_t id, uint32_t count, const std::vector<int>& listen_fds) {
+    auto first = 3;
+    auto above = first + static_cast<int>(listen_fds.size());
+    auto tmp = std::vector<int>();
+    for (int fd : listen_fds) {
+        tmp.push_back(::fcntl(fd, F_DUPFD, above));
+        ::close(fd);
+    }
+    for (size_t i = 0; i < tmp.size(); i++) {
+        ::dup2(tmp[i], first + static_cast<int>(i));
+        ::close(tmp[i]);
+    }
+    if (!listen_fds.empty()) {
+        ::setenv("LISTEN_FDS", sl::support::to_string(listen_fds.size()).c_str(), 1);
+        ::setenv("LISTEN_PID", sl::support::to_string(::getpid()).c_str(), 1);
+    }
+    ::setenv(worker_id_env_var.c_str(), sl::support::to_string(id).c_str(), 1);
+    ::setenv(workers_count_env_var.c_str(), sl::support::to_string(count).c_str(), 1);
+}
+
+} // namespace
+
+// Forks 'workers' copies of the current process. In workers returns
+// immediately with 'is_worker' set, workers continue the startup and run
+// the script. In supervisor returns after all workers are finished.
+// Workers that exited with zero code are not restarted, crashed ones
+// (non-zero exit or killed by signal) are restarted with
+// exponential backoff, on SIGINT/SIGTERM workers get SIGTERM and are waited
+// for, second signal kills them. Supervisor exit code is the last non-zero
+// exit code of a finished worker, workers stopped by supervisor are not
+// counted. Supervisor sleeps in 'poll' on the signal pipe until a signal
+// arrives or the next restart is due.
+// Must be called while the process is still single-threaded.
+pool_result run_pool(const settings& conf) {
+    auto listen_fds = std::vector<int>();
+    auto close_fds = [&listen_fds] {
+        for (int fd : listen_fds) {
+            ::close(fd);
+        }
+    };
+    try {
+        for (auto& addr : conf.listen) {
+            listen_fds.push_back(open_listen_socket(addr));
+        }
+    } catch (...) {
+        close_fds();
+        throw;
+    }
+    remote::signal_pipe sigs({SIGCHLD, SIGINT, SIGTERM, SIGHUP});
+
+    auto slots = std::vector<worker_slot>(conf.workers);
+    auto now = std::chrono::steady_clock::now();
+    for (auto& slot : slots) {
+        slot.restart_at = now;
+    }
+    std::cerr << "Supervisor started, pid: [" << ::getpid() << "], workers: [" << conf.workers << "]" << std::endl;
+
+    auto result = pool_result();
+    int signals_handled = 0;
+    for (;;) {
+        // reap
+        int status = 0;
+        pid_t pid = 0;
+        while ((pid = ::waitpid(-1, std::addressof(status), WNOHANG)) > 0) {
+            for (size_t i = 0; i < slots.size(); i++) {
+                auto& slot = slots[i];
+                if (pid != slot.pid) {
+                    continue;
+                }
+                slot.pid = 0;
+                auto crashed = !(WIFEXITED(status) && 0 == WEXITSTATUS(status));
+                if (!crashed || signals_handled > 0) {
+                    slot.finished = true;
+                    auto stopped = signals_handled > 0 && WIFSIGNALED(status) &&
+                            (SIGTERM == WTERMSIG(status) || SIGKILL == WTERMSIG(status));
+                    if (crashed && !stopped) {
+                        result.exit_code = static_cast<uint8_t>(remote::status_to_exit_code(status));
+                    }
+                    break;
+                }
+                auto now = std::chrono::steady_clock::now();
+                if (now - slot.started > stable_uptime) {
+                    slot.backoff = std::chrono::milliseconds(0);
+                }
+                slot.backoff = std::min(backoff_max, std::max(backoff_min, slot.backoff * 2));
+                slot.restart_at = now + slot.backoff;
+                std::cerr << "WARNING: worker crashed, id: [" << i << "], pid: [" << pid << "]," <<
+                        " status: [" << status << "], restart in: [" << slot.backoff.count() << "] ms" << std::endl;
+            }
+        }
+
+        // all done
+        auto running = false;
+        for (auto& slot : slots) {
+            running = running || (!slot.finished && (slot.pid > 0 || 0 == signals_handled));
+        }
+        if (!running) {
+            break;
+        }
+
+        // (re)start
+        auto timeout = std::chrono::milliseconds(-1);
+        if (0 == signals_handled) {
+            auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < slots.size(); i++) {
+                auto& slot = slots[i];
+                if (slot.finished || slot.pid > 0) {
+                    continue;
+                }
+                if (now < slot.restart_at) {
+                    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(slot.restart_at - now) +
+                            std::chrono::milliseconds(1);
+                    timeout = timeout.count() < 0 ? wait : std::min(timeout, wait);
+                    continue;
+                }
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(nullptr);
+                pid_t child = ::fork();
+                if (0 == child) {
+                    sigs.close_fds();
+                    setup_worker(static_cast<uint32_t>(i), conf.workers, listen_fds);
+                    auto res = pool_result();
+                    res.is_worker = true;
+                    res.worker_id = static_cast<uint32_t>(i);
+                    return res;
+                }
+                if (-1 == child) {
+                    std::cerr << "WARNING: worker fork error: [" << remote::errno_str() << "]" << std::endl;
+                    slot.restart_at = now + backoff_max;
+                    timeout = timeout.count() < 0 ? backoff_max : std::min(timeout, backoff_max);
+                    continue;
+                }
+                slot.pid = child;
+                slot.started = now;
+            }
+        }
+
+        // wait for a signal or for the next restart
+        std::array<struct pollfd, 1> pfds;
+        pfds[0].fd = sigs.read_fd();
+        pfds[0].events = POLLIN;
+        pfds[0].revents = 0;
+        auto polled = ::poll(pfds.data(), pfds.size(), static_cast<int>(timeout.count()));
+        if (polled <= 0 || 0 == (pfds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // stop requested
+        auto stop_signals = 0;
+        for (int sig : sigs.drain()) {
+            if (SIGCHLD != sig) {
+                stop_signals += 1;
+            }
+        }
+        if (stop_signals > 0) {
+            signals_handled += stop_signals;
+            auto sig = 1 == signals_handled ? SIGTERM : SIGKILL;
+            for (auto& slot : slots) {
+                if (slot.pid > 0) {
+                    ::kill(slot.pid, sig);
+                }
+            }
+        }
+    }
+
+    close_fds();
+    return result;
+}
+
+#else // STATICLIB_WINDOWS
+
+pool_result run_pool(const settings&) {
+    throw support::exception(TRACEMSG("Workers mode is not supported on this platform"));
+}
+
+#endif // !STATICLIB_WINDOWS
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_SUPERVISOR_HPP */
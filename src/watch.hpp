@@ -0,0 +1,365 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   watch.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:43 AM
+ */
+
+#ifndef WILTON_CLI_WATCH_HPP
+#define WILTON_CLI_WATCH_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // STATICLIB_LINUX
+
+#include "staticlib/io.hpp"
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/unzip.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "app_image.hpp"
+#include "remote_launch.hpp"
+
+namespace wilton {
+namespace cli {
+namespace watch {
+
+// Module is undefined in requirejs with 'require.undef', next 'require'
+// call loads it again through the loader; ids of modules from changed
+// binary modules are listed from their ZIP entries
+const std::string invalidate_module_source = R"(
+define(["require"], function(require) {
+    "use strict";
+    return {
+        undef: function(ids) {
+            ids.forEach(function(id) {
+                if (require.specified(id)) {
+                    require.undef(id);
+                }
+            });
+            return null;
+        }
+    };
+});
+)";
+
+// binary module file ('-b' option) and the module name it is mapped to
+struct binmod {
+    std::string path;
+    std::string name;
+};
+
+// IDs of '.js' modules in the binary module, changed file is read directly,
+// not through the process-wide index registry that keeps the old index;
+// file that cannot be read (for example is being written) gives no IDs
+std::vector<std::string> binary_module_ids(const binmod& bm) {
+    auto res = std::vector<std::string>();
+    try {
+        auto idx = sl::unzip::file_index(bm.path);
+        for (auto& en : idx.get_entries()) {
+            if (sl::utils::ends_with(en, ".js")) {
+                res.emplace_back(bm.name + "/" + en.substr(0, en.length() - 3));
+            }
+        }
+    } catch (const std::exception&) {
+        // next change event will be handled
+    }
+    return res;
+}
+
+struct changes {
+    std::set<std::string> paths;
+    std::chrono::steady_clock::time_point first_event;
+};
+
+// Reverse dependencies between the modules of the startup module directory,
+// dependencies are scanned from sources, relative IDs are resolved
+class dependency_graph {
+    std::string startmod;
+    std::string startmod_dir;
+    std::map<std::string, std::set<std::string>> deps;
+
+public:
+    dependency_graph(const std::string& startmod, const std::string& startmod_dir) :
+    startmod(startmod),
+    startmod_dir(startmod_dir) {
+        for (auto& rel : image::list_dir_recursive(startmod_dir, "")) {
+            if (sl::utils::ends_with(rel, ".js")) {
+                update(startmod_dir + rel);
+            }
+        }
+    }
+
+    dependency_graph(const dependency_graph&) = delete;
+
+    dependency_graph& operator=(const dependency_graph&) = delete;
+
+    // returns empty string for files outside of the directory
+    std::string module_id(const std::string& path) const {
+        if (!sl::utils::starts_with(path, startmod_dir) || !sl::utils::ends_with(path, ".js")) {
+            return std::string();
+        }
+        auto rel = path.substr(startmod_dir.length());
+        return startmod + "/" + rel.substr(0, rel.length() - 3);
+    }
+
+    void update(const std::string& path) {
+        auto id = module_id(path);
+        if (id.empty()) {
+            return;
+        }
+        auto& set = deps[id];
+        set.clear();
+        if (!sl::tinydir::path(path).exists()) {
+            return;
+        }
+        for (auto& dep : image::scan_dependencies(image::read_file(path))) {
+            set.insert(resolve(id, dep));
+        }
+    }
+
+    // modules that depend on any of the specified ones, directly or not,
+    // 'prefixes' match IDs of the modules with that name or under it
+    std::set<std::string> dependents(const std::set<std::string>& ids,
+            const std::vector<std::string>& prefixes) const {
+        auto res = ids;
+        bool added = true;
+        while (added) {
+            added = false;
+            for (auto& en : deps) {
+                if (res.end() != res.find(en.first)) {
+                    continue;
+                }
+                for (auto& dep : en.second) {
+                    if (res.end() != res.find(dep) || matches_prefix(dep, prefixes)) {
+                        res.insert(en.first);
+                        added = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return res;
+    }
+
+private:
+    static bool matches_prefix(const std::string& id, const std::vector<std::string>& prefixes) {
+        for (auto& pr : prefixes) {
+            if (id == pr || sl::utils::starts_with(id, pr + "/")) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::string resolve(const std::string& from_id, const std::string& dep) {
+        // plugin prefix is dropped, 'text!./foo.html' depends on './foo.html'
+        auto excl = dep.find('!');
+        auto id = std::string::npos != excl ? dep.substr(excl + 1) : dep;
+        if (!sl::utils::starts_with(id, "./") && !sl::utils::starts_with(id, "../")) {
+            return id;
+        }
+        auto parts = sl::utils::split(from_id, '/');
+        // module file name
+        if (!parts.empty()) {
+            parts.pop_back();
+        }
+        for (auto& pa : sl::utils::split(id, '/')) {
+            if (".." == pa) {
+                if (!parts.empty()) {
+                    parts.pop_back();
+                }
+            } else if ("." != pa && !pa.empty()) {
+                parts.push_back(pa);
+            }
+        }
+        auto res = std::string();
+        for (auto& pa : parts) {
+            if (!res.empty()) {
+                res.push_back('/');
+            }
+            res.append(pa);
+        }
+        return res;
+    }
+};
+
+#ifdef STATICLIB_LINUX
+
+// inotify watches on all directories under the startup module
+// directory and on the parent directories of binary modules
+class watcher {
+    int fd = -1;
+    std::map<int, std::string> dirs;
+    // directories of the startup module, all '.js' files there are tracked
+    std::set<std::string> tree_dirs;
+    std::set<std::string> files;
+
+public:
+    watcher(const std::string& startmod_dir, const std::vector<binmod>& binmods) {
+        fd = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+        if (-1 == fd) throw support::exception(TRACEMSG(
+                "'inotify_init1' error: [" + remote::errno_str() + "]"));
+        try {
+            add_tree_dir_recursive(startmod_dir, nullptr);
+            for (auto& bm : binmods) {
+                files.insert(bm.path);
+                add_dir(sl::utils::strip_filename(bm.path));
+            }
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    watcher(const watcher&) = delete;
+
+    watcher& operator=(const watcher&) = delete;
+
+    ~watcher() STATICLIB_NOEXCEPT {
+        if (-1 != fd) {
+            ::close(fd);
+        }
+    }
+
+    // blocks until something is changed, events arriving
+    // within 'debounce' after the first one are collected together
+    changes wait(std::chrono::milliseconds debounce) {
+        auto res = changes();
+        while (res.paths.empty()) {
+            poll_fd(-1);
+            res.first_event = std::chrono::steady_clock::now();
+            read_events(res.paths);
+        }
+        auto deadline = res.first_event + debounce;
+        for (auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now()) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+            if (poll_fd(static_cast<int>(left.count()))) {
+                read_events(res.paths);
+            }
+        }
+        return res;
+    }
+
+private:
+    // returns directory path with trailing slash
+    std::string add_dir(const std::string& dir) {
+        auto dir_slash = sl::utils::ends_with(dir, "/") ? dir : dir + "/";
+        for (auto& en : dirs) {
+            if (dir_slash == en.second) {
+                return dir_slash;
+            }
+        }
+        auto wd = ::inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY);
+        if (-1 == wd) throw support::exception(TRACEMSG(
+                "'inotify_add_watch' error, path: [" + dir + "], error: [" + remote::errno_str() + "]"));
+        dirs[wd] = dir_slash;
+        return dir_slash;
+    }
+
+    // all directories are added to 'tree_dirs', '.js' files found
+    // in them are added to 'js_files' if it is specified
+    void add_tree_dir_recursive(const std::string& dir, std::set<std::string>* js_files) {
+        auto dir_slash = add_dir(dir);
+        tree_dirs.insert(dir_slash);
+        for (auto& ch : sl::tinydir::list_directory(dir)) {
+            if (ch.is_directory()) {
+                add_tree_dir_recursive(dir_slash + ch.filename(), js_files);
+            } else if (nullptr != js_files && sl::utils::ends_with(ch.filename(), ".js")) {
+                js_files->insert(dir_slash + ch.filename());
+            }
+        }
+    }
+
+    bool poll_fd(int timeout_millis) {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return ::poll(std::addressof(pfd), 1, timeout_millis) > 0;
+    }
+
+    void read_events(std::set<std::string>& paths) {
+        alignas(struct inotify_event) std::array<char, 16384> buf;
+        for (;;) {
+            auto len = ::read(fd, buf.data(), buf.size());
+            if (len <= 0) {
+                return;
+            }
+            for (ssize_t off = 0; off < len;) {
+                auto ev = reinterpret_cast<const struct inotify_event*>(buf.data() + off);
+                off += static_cast<ssize_t>(sizeof(struct inotify_event) + ev->len);
+                auto it = dirs.find(ev->wd);
+                if (dirs.end() == it || 0 == ev->len) {
+                    continue;
+                }
+                auto path = it->second + std::string(ev->name);
+                auto in_tree = tree_dirs.end() != tree_dirs.find(it->second);
+                if (in_tree && (ev->mask & IN_ISDIR) && (ev->mask & (IN_CREATE | IN_MOVED_TO))) {
+                    // files can be created or moved in before the watch is added
+                    add_tree_dir_recursive(path, std::addressof(paths));
+                    continue;
+                }
+                // parent dirs of binary modules may contain other files
+                if (files.end() != files.find(path) || (in_tree && sl::utils::ends_with(path, ".js"))) {
+                    paths.insert(path);
+                }
+            }
+        }
+    }
+};
+
+#else // !STATICLIB_LINUX
+
+class watcher {
+public:
+    watcher(const std::string&, const std::vector<binmod>&) {
+        throw support::exception(TRACEMSG("Watch mode is supported on Linux only"));
+    }
+
+    changes wait(std::chrono::milliseconds) {
+        return changes();
+    }
+};
+
+#endif // STATICLIB_LINUX
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_WATCH_HPP */
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_index.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:21 AM
+ */
+
+#ifndef WILTON_CLI_ZIP_INDEX_HPP
+#define WILTON_CLI_ZIP_INDEX_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "staticlib/unzip.hpp"
+
+#include "startup_trace.hpp"
+
+namespace wilton {
+namespace cli {
+namespace zip {
+
+// Central directory of each archive is parsed once per process and shared
+// by the launcher code that reads many entries of the same archive: image
+// build and load and crypt cache prefill.
+// Archive is parsed outside of the lock, if two threads parse the same
+// archive concurrently, the index inserted first is kept.
+class index_registry {
+    std::mutex mtx;
+    std::map<std::string, std::shared_ptr<sl::unzip::file_index>> indices;
+
+public:
+    std::shared_ptr<sl::unzip::file_index> get(const std::string& zip_path) {
+        {
+            std::lock_guard<std::mutex> guard{mtx};
+            auto it = indices.find(zip_path);
+            if (indices.end() != it) {
+                return it->second;
+            }
+        }
+        auto idx = [&zip_path] {
+            trace::phase ph("zip::index", zip_path);
+            return std::make_shared<sl::unzip::file_index>(zip_path);
+        }();
+        std::lock_guard<std::mutex> guard{mtx};
+        auto pa = indices.insert(std::make_pair(zip_path, std::move(idx)));
+        return pa.first->second;
+    }
+};
+
+index_registry& global_registry() {
+    static index_registry instance;
+    return instance;
+}
+
+std::shared_ptr<sl::unzip::file_index> open_index(const std::string& zip_path) {
+    return global_registry().get(zip_path);
+}
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_ZIP_INDEX_HPP */
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_writer.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:34 AM
+ */
+
+#ifndef WILTON_CLI_ZIP_WRITER_HPP
+#define WILTON_CLI_ZIP_WRITER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "zlib.h"
+
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+#include "staticlib/utils.hpp"
+
+#include "wilton/support/exception.hpp"
+
+namespace wilton {
+namespace cli {
+namespace zip {
+
+// Minimal ZIP (no ZIP64) writer, entries are deflated in memory,
+// timestamps are fixed to keep images reproducible. File is written
+// next to the target and renamed in 'finish', so a failed build never
+// leaves a truncated file in place of the previous one.
+class writer {
+    struct central_entry {
+        std::string name;
+        uint16_t method = 0;
+        uint32_t crc = 0;
+        uint32_t compressed_size = 0;
+        uint32_t size = 0;
+        uint32_t offset = 0;
+    };
+
+    std::string path;
+    std::string tmp_path;
+    std::unique_ptr<sl::tinydir::file_sink> sink;
+    uint64_t written = 0;
+    std::vector<central_entry> entries;
+    std::set<std::string> names;
+
+public:
+    writer(const std::string& zip_path) :
+    path(zip_path),
+    tmp_path(zip_path + "." + sl::utils::random_string_generator().generate(8) + ".tmp"),
+    sink(new sl::tinydir::file_sink(sl::tinydir::path(tmp_path).open_write())) { }
+
+    writer(const writer&) = delete;
+
+    writer& operator=(const writer&) = delete;
+
+    // unfinished file is removed, target is left untouched
+    ~writer() STATICLIB_NOEXCEPT {
+        if (nullptr != sink.get()) {
+            sink.reset();
+            std::remove(tmp_path.c_str());
+        }
+    }
+
+    // entries are written to this file until 'finish' is called
+    const std::string& temp_path() const {
+        return tmp_path;
+    }
+
+    bool contains(const std::string& name) const {
+        return names.end() != names.find(name);
+    }
+
+    void add_entry(const std::string& name, const std::string& data) {
+        if (contains(name)) throw support::exception(TRACEMSG(
+                "Duplicate ZIP entry: [" + name + "], file: [" + path + "]"));
+        if (data.length() > std::numeric_limits<uint32_t>::max() ||
+                entries.size() >= std::numeric_limits<uint16_t>::max()) throw support::exception(TRACEMSG(
+                "ZIP64 is not supported, entry: [" + name + "], file: [" + path + "]"));
+        auto en = central_entry();
+        en.name = name;
+        en.size = static_cast<uint32_t>(data.length());
+        en.crc = static_cast<uint32_t>(::crc32(::crc32(0L, Z_NULL, 0),
+                reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.length())));
+        auto deflated = deflate_raw(data);
+        auto& payload = deflated.length() < data.length() ? deflated : data;
+        en.method = deflated.length() < data.length() ? 8 : 0;
+        en.compressed_size = static_cast<uint32_t>(payload.length());
+        en.offset = checked_offset();
+
+        auto header = std::string();
+        put32(header, 0x04034b50);
+        put16(header, 20); // version needed
+        put16(header, 0x0800); // UTF-8 names
+        put16(header, en.method);
+        put16(header, 0); // time
+        put16(header, 0x21); // date, 1980-01-01
+        put32(header, en.crc);
+        put32(header, en.compressed_size);
+        put32(header, en.size);
+        put16(header, static_cast<uint16_t>(name.length()));
+        put16(header, 0); // extra
+        header.append(name);
+        write(header);
+        write(payload);
+        entries.emplace_back(std::move(en));
+        names.insert(name);
+    }
+
+    void finish() {
+        auto cd_offset = checked_offset();
+        auto cd = std::string();
+        for (auto& en : entries) {
+            put32(cd, 0x02014b50);
+            put16(cd, 20); // version made by
+            put16(cd, 20); // version needed
+            put16(cd, 0x0800);
+            put16(cd, en.method);
+            put16(cd, 0);
+            put16(cd, 0x21);
+            put32(cd, en.crc);
+            put32(cd, en.compressed_size);
+            put32(cd, en.size);
+            put16(cd, static_cast<uint16_t>(en.name.length()));
+            put16(cd, 0); // extra
+            put16(cd, 0); // comment
+            put16(cd, 0); // disk
+            put16(cd, 0); // internal attrs
+            put32(cd, 0); // external attrs
+            put32(cd, en.offset);
+            cd.append(en.name);
+        }
+        auto count = static_cast<uint16_t>(entries.size());
+        auto eocd = std::string();
+        put32(eocd, 0x06054b50);
+        put16(eocd, 0);
+        put16(eocd, 0);
+        put16(eocd, count);
+        put16(eocd, count);
+        put32(eocd, static_cast<uint32_t>(cd.length()));
+        put32(eocd, cd_offset);
+        put16(eocd, 0); // comment
+        write(cd);
+        write(eocd);
+        sink.reset();
+#ifdef STATICLIB_WINDOWS
+        std::remove(path.c_str());
+#endif // STATICLIB_WINDOWS
+        if (0 != std::rename(tmp_path.c_str(), path.c_str())) {
+            std::remove(tmp_path.c_str());
+            throw support::exception(TRACEMSG("Error writing ZIP file, path: [" + path + "]"));
+        }
+    }
+
+private:
+    uint32_t checked_offset() {
+        if (written > std::numeric_limits<uint32_t>::max()) throw support::exception(TRACEMSG(
+                "ZIP64 is not supported, file: [" + path + "]"));
+        return static_cast<uint32_t>(written);
+    }
+
+    void write(const std::string& data) {
+        sl::io::write_all(*sink, {data.data(), data.length()});
+        written += data.length();
+    }
+
+    static void put16(std::string& buf, uint16_t val) {
+        buf.push_back(static_cast<char>(val & 0xff));
+        buf.push_back(static_cast<char>((val >> 8) & 0xff));
+    }
+
+    static void put32(std::string& buf, uint32_t val) {
+        put16(buf, static_cast<uint16_t>(val & 0xffff));
+        put16(buf, static_cast<uint16_t>((val >> 16) & 0xffff));
+    }
+
+    std::string deflate_raw(const std::string& data) {
+        z_stream zs;
+        std::memset(std::addressof(zs), '\0', sizeof(zs));
+        auto err_init = ::deflateInit2(std::addressof(zs), Z_BEST_COMPRESSION, Z_DEFLATED,
+                -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        if (Z_OK != err_init) throw support::exception(TRACEMSG(
+                "'deflateInit2' error, code: [" + sl::support::to_string(err_init) + "]"));
+        auto deferred = sl::support::defer([&zs]() STATICLIB_NOEXCEPT {
+            ::deflateEnd(std::addressof(zs));
+        });
+        auto res = std::string();
+        res.resize(::deflateBound(std::addressof(zs), static_cast<uLong>(data.length())));
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        zs.avail_in = static_cast<uInt>(data.length());
+        zs.next_out = reinterpret_cast<Bytef*>(std::addressof(res.front()));
+        zs.avail_out = static_cast<uInt>(res.length());
+        auto err = ::deflate(std::addressof(zs), Z_FINISH);
+        if (Z_STREAM_END != err) throw support::exception(TRACEMSG(
+                "'deflate' error, code: [" + sl::support::to_string(err) + "]"));
+        res.resize(zs.total_out);
+        return res;
+    }
+};
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_ZIP_WRITER_HPP */
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2026, agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zygote.hpp
+ * Author: agent
+ *
+ * Created on October 16, 2026, 11:24 AM
+ */
+
+#ifndef WILTON_CLI_ZYGOTE_HPP
+#define WILTON_CLI_ZYGOTE_HPP
+
+#include <array>
+#include <csignal>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // !STATICLIB_WINDOWS
+
+#include "staticlib/json.hpp"
+#include "staticlib/support.hpp"
+
+#include "wilton/support/exception.hpp"
+
+#include "remote_launch.hpp"
+
+namespace wilton {
+namespace cli {
+namespace zygote {
+
+#ifndef STATICLIB_WINDOWS
+
+namespace { // anonymous
+
+void reply(int fd, const sl::json::value& json) {
+    try {
+        remote::write_line(fd, sl::json::dumps(json));
+    } catch (const std::exception&) {
+        // client gone
+    }
+}
+
+void reap_jobs(std::map<pid_t, int>& jobs) {
+    int status = 0;
+    pid_t pid = 0;
+    while ((pid = ::waitpid(-1, std::addressof(status), WNOHANG)) > 0) {
+        auto it = jobs.find(pid);
+        if (jobs.end() != it) {
+            reply(it->second, {{"exitCode", remote::status_to_exit_code(status)}});
+            ::close(it->second);
+            jobs.erase(it);
+        }
+    }
+}
+
+} // namespace
+
+// Serves launch requests from the already initialized process, each job
+// runs 'job_fun' in a forked child with client stdio, env and cwd.
+// Parent stays single-threaded, so it must not start any threads itself.
+// Parent sleeps in 'poll' on the socket and on the signal pipe, job exit
+// codes are relayed as soon as SIGCHLD is received. Requests are read
+// with a deadline, so a client that connects and sends nothing only
+// delays other launches by 'remote::request_timeout_millis'.
+void serve(const std::string& socket_path, std::function<uint8_t(const remote::request&)> job_fun) {
+    int lfd = remote::listen_socket(socket_path);
+    auto deferred = sl::support::defer([lfd, &socket_path]() STATICLIB_NOEXCEPT {
+        ::close(lfd);
+        ::unlink(socket_path.c_str());
+    });
+    remote::signal_pipe sigs({SIGCHLD, SIGINT, SIGTERM});
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cerr << "Zygote is listening on socket: [" << socket_path << "]" << std::endl;
+
+    // job pid -> client connection
+    auto jobs = std::map<pid_t, int>();
+    auto stopping = false;
+    while (!stopping || !jobs.empty()) {
+        // running jobs are drained after stop is requested
+        std::array<struct pollfd, 2> pfds;
+        pfds[0].fd = sigs.read_fd();
+        pfds[1].fd = lfd;
+        for (auto& pfd : pfds) {
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+        }
+        auto polled = ::poll(pfds.data(), stopping ? 1 : 2, -1);
+        if (polled <= 0) {
+            continue;
+        }
+        if (0 != (pfds[0].revents & POLLIN)) {
+            for (int sig : sigs.drain()) {
+                if (SIGINT == sig || SIGTERM == sig) {
+                    stopping = true;
+                }
+            }
+            reap_jobs(jobs);
+        }
+        if (stopping || 0 == (pfds[1].revents & POLLIN)) {
+            continue;
+        }
+
+        // read request
+        int cfd = ::accept(lfd, nullptr, nullptr);
+        if (-1 == cfd) {
+            continue;
+        }
+        if (!remote::peer_is_same_user(cfd)) {
+            reply(cfd, {{"error", "client user does not match zygote user"}});
+            ::close(cfd);
+            continue;
+        }
+        auto req = remote::request();
+        try {
+            req = remote::receive_request(cfd);
+        } catch (const std::exception& e) {
+            reply(cfd, {{"error", std::string(e.what())}});
+            ::close(cfd);
+            continue;
+        }
+
+        // start job
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        pid_t child = ::fork();
+        if (0 == child) {
+            ::close(lfd);
+            ::close(cfd);
+            for (auto& pa : jobs) {
+                ::close(pa.second);
+            }
+            sigs.close_fds();
+            std::signal(SIGPIPE, SIG_DFL);
+            ::dup2(req.stdio_fds[0], STDIN_FILENO);
+            ::dup2(req.stdio_fds[1], STDOUT_FILENO);
+            ::dup2(req.stdio_fds[2], STDERR_FILENO);
+            remote::close_stdio_fds(req);
+            uint8_t code = 1;
+            try {
+                remote::apply_request_env(req);
+                code = job_fun(req);
+            } catch (const std::exception& e) {
+                std::cerr << "ERROR: " << e.what() << std::endl;
+            }
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+            // static destructors of the parent state must not run in job
+            ::_exit(code);
+        }
+        remote::close_stdio_fds(req);
+        if (-1 == child) {
+            reply(cfd, {{"error", "fork error: [" + remote::errno_str() + "]"}});
+            ::close(cfd);
+            continue;
+        }
+        // client gone, job result will be discarded
+        reply(cfd, {{"pid", static_cast<int64_t>(child)}});
+        jobs.insert(std::make_pair(child, cfd));
+    }
+}
+
+#else // STATICLIB_WINDOWS
+
+void serve(const std::string&, std::function<uint8_t(const remote::request&)>) {
+    throw support::exception(TRACEMSG("Zygote mode is not supported on this platform"));
+}
+
+#endif // !STATICLIB_WINDOWS
+
+} // namespace
+}
+}
+
+#endif /* WILTON_CLI_ZYGOTE_HPP */